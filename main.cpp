@@ -14,6 +14,9 @@ const int ver{0};
 
 static void SIGINT_exit(int);
 
+// Set while encode_and_solve_abws runs, which stops on interrupt_requested and prints its bounds.
+static volatile sig_atomic_t search_running = 0;
+
 static void (*signal_SIGINT)(int);
 static void (*signal_SIGXCPU)(int);
 static void (*signal_SIGSEGV)(int);
@@ -28,6 +31,13 @@ static void SIGINT_exit(int signum)
     signal(SIGTERM, signal_SIGTERM);
     signal(SIGABRT, signal_SIGABRT);
 
+    // Only the flag is safe to touch here, the search stops at its next check. A second signal ends the process.
+    if (search_running && signum != SIGSEGV && signum != SIGABRT)
+    {
+        interrupt_requested.store(signum, std::memory_order_relaxed);
+        return;
+    }
+
     std::cout << "c Signal interruption." << std::endl;
 
     fflush(stdout);
@@ -43,6 +53,7 @@ static const std::map<std::string, std::string> option_list = {
     {"--product", "Use 2-Product encoding for staircase constraints [default: false]"},
     {"--duplex", "Use duplex encoding for staircase constraints [default: true]"},
     {"--ladder", "Use ladder encoding for staircase constraints and NSC for At-Most-One constraints [default: false]"},
+    {"--order", "Use order encoding of the labels, every window of an edge is one clause without aux variables, meant for large widths [default: false]"},
     {"--conf-sat", "Use --sat configuration of CaDiCaL [default: true]"},
     {"--conf-unsat", "Use --unsat configuration of CaDiCaL [default: false]"},
     {"--conf-def", "Use default configuration of CaDiCaL [default: false]"},
@@ -50,12 +61,40 @@ static const std::map<std::string, std::string> option_list = {
     {"--check-solution", "Calculate the antibandwidth of the found SAT solution and compare it to the actual width [default: false]"},
     {"--from-ub", "Start solving with width = UB, decreasing in each iteration [default: false]"},
     {"--from-lb", "Start solving with width = LB, increasing in each iteration [default: true]"},
+    {"--incremental", "Keep one CaDiCaL instance for all widths: labelling constraints are encoded once, staircase constraints of each width are enabled through an assumed selector literal [default: false]"},
     {"--bin-search", "Start solving with LB+UB/2 and update LB or UB according to SAT/UNSAT result and repeat"},
+    {"--galloping", "Probe LB, then LB+1, +2, +4, ... above the last SAT width until UNSAT, then binary search the gap [default: false]"},
+    {"--cost-model", "Pick each next width by the measured SAT/UNSAT solving times to minimise the expected remaining time [default: false]"},
+    {"--parallel", "Probe several widths between LB and UB at once on separate threads, sharing proven bounds and cancelling decided widths [default: false]"},
+    {"-threads <t>", "Number of threads used by --parallel [default: number of hardware cores]"},
+    {"-portfolio <k>", "Solve each width with k differently configured CaDiCaL instances on k threads, the first answer stops the others [default: 1]"},
+    {"--no-structural-bounds", "Do not tighten LB/UB with the degree, clique and closed-form bounds of the graph [default: false]"},
+    {"--no-heuristic-lb", "Do not raise LB with the built-in level-structure and greedy labelling heuristics [default: false]"},
+    {"-heuristic-out <file>", "Write the best heuristic labelling to <file>, one '<node> <label>' line per node"},
+    {"--seed-phases", "Before each solve, try the last SAT model (or the best heuristic labelling) as assumptions under a conflict limit [default: false]"},
+    {"-seed-labelling <file>", "Seed the first solve with the labelling in <file> ('<node> <label>' lines), implies --seed-phases"},
+    {"-seed-conflicts <c>", "Conflict limit of one seeded solve round [default: 2000]"},
+    {"--transfer-clauses", "Pass label-only units and clauses derived at a width on to the solvers of larger widths (not with --incremental or --parallel) [default: false]"},
+    {"-transfer-size <k>", "Longest clause passed on by --transfer-clauses [default: 8]"},
+    {"-width-conflicts <c>", "Conflict budget of one width, a width out of budget is UNKNOWN and retried later with a bigger budget"},
+    {"-width-decisions <d>", "Decision budget of one width, see -width-conflicts"},
+    {"-width-time <s>", "Time budget of one width in seconds, see -width-conflicts"},
+    {"-budget-retries <r>", "Number of times the unknown widths are retried with a doubled budget [default: 3]"},
+    {"-time-limit <s>", "Stop solving just before <s> seconds and print the best bounds and labelling found on an 'r' line"},
+    {"-checkpoint <file>", "Append the result of every decided width, the proven bounds and the best labelling to <file>"},
+    {"-resume <file>", "Continue the search from the bounds, labelling and unknown widths in checkpoint <file>, and keep appending to it"},
+    {"-bounds-db <file>", "Start from the best bounds stored for this graph in <file> and store the newly proven bounds and labelling there"},
     {"-split-size <n>", "Maximal allowed length of clauses, every longer clause is split up into two by introducing a new variable"},
+    {"--aggregate-glue", "Glue the ladder and duplex staircases of a node to all its neighbours through one literal per window, fewer glue clauses on graphs with hubs [default: false]"},
+    {"--clique-cover", "Cover the edges greedily with cliques and encode one At-Most-One per clique and window instead of one per edge, with --seq and --product [default: false]"},
+    {"--prune-domains", "Fix the labels that the degree of a node and propagation rule out at the probed width to false and skip the width clauses they satisfy [default: false]"},
+    {"-prune-rounds <r>", "Run at most <r> propagation rounds of --prune-domains after the degree rule [default: 10]"},
+    {"-encode-threads <t>", "Encode the staircases of the ladder and duplex encodings on <t> threads, the formula stays the same (not with -split-size) [default: 1]"},
     {"-set-lb <new LB>", "Overwrite predefined LB with <new LB>, has to be at least 2"},
     {"-set-ub <new UB>", "Overwrite predefined UB with <new UB>, has to be positive"},
     {"-symmetry-break <break point>", "Apply symetry breaking technique in <break point> (f: first node, h: highest degree node, l: lowest degree node, n: none) [default: none]"},
-    {"-print-w <w>", "Only encode and print SAT formula of specified width w (where w > 0), without solving it"}};
+    {"-print-w <w>", "Only encode and print SAT formula of specified width w (where w > 0), without solving it"},
+    {"-print-out <file>", "Write the -print-w formula to <file> instead of stdout"}};
 
 int get_number_arg(std::string const &arg)
 {
@@ -154,6 +193,10 @@ int main(int argc, char **argv)
         {
             abw_enc->enc_choice = EncoderType::ladder;
         }
+        else if (argv[i] == std::string("--order"))
+        {
+            abw_enc->enc_choice = EncoderType::order;
+        }
         else if (argv[i] == std::string("--conf-sat"))
         {
             abw_enc->sat_configuration = "sat";
@@ -186,6 +229,33 @@ int main(int argc, char **argv)
         {
             abw_enc->enc_strategy = EncoderStrategy::bin_search;
         }
+        else if (argv[i] == std::string("--galloping"))
+        {
+            abw_enc->enc_strategy = EncoderStrategy::galloping;
+        }
+        else if (argv[i] == std::string("--cost-model"))
+        {
+            abw_enc->enc_strategy = EncoderStrategy::cost_model;
+        }
+        else if (argv[i] == std::string("--parallel"))
+        {
+            abw_enc->enc_strategy = EncoderStrategy::parallel;
+        }
+        else if (argv[i] == std::string("-threads"))
+        {
+            abw_enc->thread_count = get_number_arg(argv[++i]);
+            if (abw_enc->thread_count < 1)
+            {
+                std::cout << "Error, number of threads has to be at least 1." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            std::cout << "c Using " << abw_enc->thread_count << " threads." << std::endl;
+        }
+        else if (argv[i] == std::string("--incremental"))
+        {
+            abw_enc->incremental = true;
+        }
         else if (argv[i] == std::string("-print-w"))
         {
             spec_w = get_number_arg(argv[++i]);
@@ -198,6 +268,11 @@ int main(int argc, char **argv)
             std::cout << "c DIMACS Printing mode for w = " << spec_w << "." << std::endl;
             just_print_dimacs = true;
         }
+        else if (argv[i] == std::string("-print-out"))
+        {
+            abw_enc->dimacs_file = argv[++i];
+            std::cout << "c DIMACS formula is written to " << abw_enc->dimacs_file << "." << std::endl;
+        }
         else if (argv[i] == std::string("-set-lb"))
         {
             abw_enc->forced_lb = get_number_arg(argv[++i]);
@@ -222,6 +297,121 @@ int main(int argc, char **argv)
             abw_enc->overwrite_ub = true;
             std::cout << "c UB is predefined as " << abw_enc->forced_ub << "." << std::endl;
         }
+        else if (argv[i] == std::string("-portfolio"))
+        {
+            abw_enc->portfolio_size = get_number_arg(argv[++i]);
+            if (abw_enc->portfolio_size < 1)
+            {
+                std::cout << "Error, portfolio size has to be at least 1." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            std::cout << "c Portfolio of " << abw_enc->portfolio_size << " solvers per width." << std::endl;
+        }
+        else if (argv[i] == std::string("--no-structural-bounds"))
+        {
+            abw_enc->structural_bounds = false;
+        }
+        else if (argv[i] == std::string("--no-heuristic-lb"))
+        {
+            abw_enc->heuristic_lb = false;
+        }
+        else if (argv[i] == std::string("-heuristic-out"))
+        {
+            abw_enc->heuristic_labelling_file = argv[++i];
+            std::cout << "c Heuristic labelling is written to " << abw_enc->heuristic_labelling_file << "." << std::endl;
+        }
+        else if (argv[i] == std::string("--seed-phases"))
+        {
+            abw_enc->seed_phases = true;
+        }
+        else if (argv[i] == std::string("-seed-labelling"))
+        {
+            abw_enc->seed_labelling_file = argv[++i];
+            std::cout << "c Seed labelling is taken from " << abw_enc->seed_labelling_file << "." << std::endl;
+        }
+        else if (argv[i] == std::string("-seed-conflicts"))
+        {
+            abw_enc->seed_conflicts = get_number_arg(argv[++i]);
+            if (abw_enc->seed_conflicts < 1)
+            {
+                std::cout << "Error, seed conflict limit has to be at least 1." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            std::cout << "c Seeded solve rounds are limited to " << abw_enc->seed_conflicts << " conflicts." << std::endl;
+        }
+        else if (argv[i] == std::string("--transfer-clauses"))
+        {
+            abw_enc->transfer_clauses = true;
+        }
+        else if (argv[i] == std::string("-transfer-size"))
+        {
+            int transfer_size = get_number_arg(argv[++i]);
+            if (transfer_size < 1)
+            {
+                std::cout << "Error, transfer clause size has to be at least 1." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            abw_enc->transfer_max_size = transfer_size;
+            std::cout << "c Transferring clauses up to length " << transfer_size << "." << std::endl;
+        }
+        else if (argv[i] == std::string("-width-conflicts") || argv[i] == std::string("-width-decisions") || argv[i] == std::string("-width-time"))
+        {
+            std::string option = argv[i];
+            int limit = get_number_arg(argv[++i]);
+            if (limit < 1)
+            {
+                std::cout << "Error, budget has to be at least 1." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            if (option == std::string("-width-conflicts"))
+                abw_enc->width_budget.conflicts = limit;
+            else if (option == std::string("-width-decisions"))
+                abw_enc->width_budget.decisions = limit;
+            else
+                abw_enc->width_budget.seconds = limit;
+            std::cout << "c Per-width budget: " << abw_enc->width_budget.describe() << "." << std::endl;
+        }
+        else if (argv[i] == std::string("-budget-retries"))
+        {
+            abw_enc->budget_retries = get_number_arg(argv[++i]);
+            if (abw_enc->budget_retries < 0)
+            {
+                std::cout << "Error, number of budget retries can not be negative." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            std::cout << "c Unknown widths are retried " << abw_enc->budget_retries << " times." << std::endl;
+        }
+        else if (argv[i] == std::string("-time-limit"))
+        {
+            abw_enc->time_limit = get_number_arg(argv[++i]);
+            if (abw_enc->time_limit < 1)
+            {
+                std::cout << "Error, time limit has to be at least 1 second." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            std::cout << "c Time limit is " << abw_enc->time_limit << " s." << std::endl;
+        }
+        else if (argv[i] == std::string("-checkpoint"))
+        {
+            abw_enc->checkpoint_file = argv[++i];
+            std::cout << "c Checkpoints are appended to " << abw_enc->checkpoint_file << "." << std::endl;
+        }
+        else if (argv[i] == std::string("-resume"))
+        {
+            abw_enc->resume_file = argv[++i];
+            std::cout << "c Resuming from checkpoint " << abw_enc->resume_file << "." << std::endl;
+        }
+        else if (argv[i] == std::string("-bounds-db"))
+        {
+            abw_enc->bounds_db_file = argv[++i];
+            std::cout << "c Bounds database: " << abw_enc->bounds_db_file << "." << std::endl;
+        }
         else if (argv[i] == std::string("-split-size"))
         {
             split_size = get_number_arg(argv[++i]);
@@ -234,6 +424,41 @@ int main(int argc, char **argv)
             std::cout << "c Splitting clauses at length " << split_size << "." << std::endl;
             abw_enc->split_limit = split_size;
         }
+        else if (argv[i] == std::string("--aggregate-glue"))
+        {
+            abw_enc->aggregate_glue = true;
+        }
+        else if (argv[i] == std::string("--clique-cover"))
+        {
+            abw_enc->clique_cover = true;
+        }
+        else if (argv[i] == std::string("--prune-domains"))
+        {
+            abw_enc->prune_domains = true;
+        }
+        else if (argv[i] == std::string("-prune-rounds"))
+        {
+            int prune_rounds = get_number_arg(argv[++i]);
+            if (prune_rounds < 0)
+            {
+                std::cout << "Error, the number of pruning rounds can not be negative." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            abw_enc->prune_rounds = prune_rounds;
+        }
+        else if (argv[i] == std::string("-encode-threads"))
+        {
+            int encode_threads = get_number_arg(argv[++i]);
+            if (encode_threads < 1)
+            {
+                std::cout << "Error, the number of encoding threads has to be positive." << std::endl;
+                delete abw_enc;
+                return 1;
+            }
+            std::cout << "c Encoding on " << encode_threads << " threads." << std::endl;
+            abw_enc->encode_threads = encode_threads;
+        }
         else if (argv[i] == std::string("-symmetry-break"))
         {
             std::string break_point = argv[++i];
@@ -280,9 +505,15 @@ int main(int argc, char **argv)
     }
     else
     {
+        search_running = 1;
         abw_enc->encode_and_solve_abws();
+        search_running = 0;
     }
 
     delete abw_enc;
+    // The handler restored the previous handlers, end as the signal would have.
+    int interrupt_signal = interrupt_requested.load(std::memory_order_relaxed);
+    if (interrupt_signal)
+        raise(interrupt_signal);
     return 0;
 }
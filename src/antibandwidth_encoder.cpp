@@ -3,10 +3,26 @@
 #include <iostream>
 #include <assert.h>
 #include <chrono>
+#include <thread>
+#include <algorithm>
 
 namespace SATABP
 {
 
+    namespace
+    {
+        // Instantiates the encoder for the concrete type of cc, so it adds clauses without virtual calls.
+        template <template <class> class SinkEncoder>
+        Encoder *new_sink_encoder(Graph *g, ClauseContainer *cc, VarHandler *vh)
+        {
+            if (CadicalClauseContainer *cadical_cc = dynamic_cast<CadicalClauseContainer *>(cc))
+                return new SinkEncoder<CadicalClauseContainer>(g, cadical_cc, vh);
+            if (DimacsWriter *writer = dynamic_cast<DimacsWriter *>(cc))
+                return new SinkEncoder<DimacsWriter>(g, writer, vh);
+            return new SinkEncoder<ClauseContainer>(g, cc, vh);
+        }
+    }
+
     AntibandwidthEncoder::AntibandwidthEncoder() {};
 
     AntibandwidthEncoder::~AntibandwidthEncoder()
@@ -21,24 +37,215 @@ namespace SATABP
 
     void AntibandwidthEncoder::encode_and_solve_abws()
     {
-        switch (enc_strategy)
+        if (time_limit > 0)
         {
-        case from_lb:
-            std::cout << "c Solving strategy: from LB to UB." << std::endl;
-            encode_and_solve_abw_problems_from_lb();
-            break;
-        case from_ub:
-            std::cout << "c Solving strategy: from UB to LB." << std::endl;
-            encode_and_solve_abw_problems_from_ub();
-            break;
-        case bin_search:
-            std::cout << "c Solving strategy: binary search between LB and UB." << std::endl;
-            encode_and_solve_abw_problems_bin_search();
-            break;
-        default:
-            std::cerr << "c Unrecognized encoder strategy " << enc_strategy << "." << std::endl;
+            // Leave a moment to stop the solver and print the results.
+            int margin = std::max(1, time_limit / 100);
+            int solving_time = std::max(1, time_limit - margin);
+            run_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(solving_time);
+            std::cout << "c Time limit: " << time_limit << " s, solving stops after " << solving_time << " s." << std::endl;
+        }
+        if (incremental && enc_strategy == parallel)
+        {
+            std::cout << "c Incremental solving is not used by the parallel strategy, every width gets its own solver." << std::endl;
+            incremental = false;
+        }
+        if (transfer_clauses && (incremental || enc_strategy == parallel))
+        {
+            std::cout << "c Clause transfer is only used when every width gets a new solver one after the other." << std::endl;
+            transfer_clauses = false;
+        }
+        if (transfer_clauses)
+            transfer = new ClauseTransfer(g->n * g->n, transfer_max_size);
+        if (checkpoint_file.empty())
+            checkpoint_file = resume_file;
+        if (!checkpoint_file.empty())
+            checkpoint = new Checkpoint(checkpoint_file, g, encoder_name());
+        if (incremental)
+            setup_for_incremental_solving();
+        if (!seed_labelling_file.empty() && LabellingHeuristics::read_labelling(seed_labelling_file, g->n, seed_labels))
+        {
+            seed_phases = true;
+            std::cout << "c Seed labelling is read from " << seed_labelling_file << "." << std::endl;
+        }
+
+        if (width_budget.is_limited() && enc_strategy == parallel)
+            std::cout << "c Per-width budgets are not used by the parallel strategy." << std::endl;
+
+        if (width_budget.is_limited() && enc_strategy != parallel)
+        {
+            std::cout << "c Solving strategy: budgeted search, every width gets " << width_budget.describe() << "." << std::endl;
+            encode_and_solve_abw_problems_with_budget();
+        }
+        else
+        {
+            switch (enc_strategy)
+            {
+            case from_lb:
+                std::cout << "c Solving strategy: from LB to UB." << std::endl;
+                encode_and_solve_abw_problems_from_lb();
+                break;
+            case from_ub:
+                std::cout << "c Solving strategy: from UB to LB." << std::endl;
+                encode_and_solve_abw_problems_from_ub();
+                break;
+            case bin_search:
+                std::cout << "c Solving strategy: binary search between LB and UB." << std::endl;
+                encode_and_solve_abw_problems_bin_search();
+                break;
+            case parallel:
+                std::cout << "c Solving strategy: parallel probing of widths between LB and UB." << std::endl;
+                encode_and_solve_abw_problems_parallel();
+                break;
+            case galloping:
+                std::cout << "c Solving strategy: galloping from LB, then binary search." << std::endl;
+                encode_and_solve_abw_problems_galloping();
+                break;
+            case cost_model:
+                std::cout << "c Solving strategy: cost model of the measured SAT and UNSAT widths." << std::endl;
+                encode_and_solve_abw_problems_cost_model();
+                break;
+            default:
+                std::cerr << "c Unrecognized encoder strategy " << enc_strategy << "." << std::endl;
+                break;
+            }
+        }
+
+        if (incremental)
+            cleanup_solving();
+        if (transfer)
+        {
+            std::cout << "c Clause transfer: " << transfer->total_harvested() << " clauses harvested, ";
+            std::cout << transfer->total_injected() << " clause additions into later widths." << std::endl;
+            delete transfer;
+            transfer = nullptr;
+        }
+        delete checkpoint;
+        checkpoint = nullptr;
+        if (!bounds_db_file.empty())
+            store_bounds_db();
+
+        if (interrupt_requested.load(std::memory_order_relaxed))
+            std::cout << "c Signal interruption, the search was stopped." << std::endl;
+        print_final_bounds();
+    };
+
+    void AntibandwidthEncoder::print_final_bounds() const
+    {
+        std::string status = "open";
+        if (best_ub > 0 && best_lb >= best_ub)
+            status = "optimal";
+        else if (interrupt_requested.load(std::memory_order_relaxed))
+            status = "interrupted";
+        else if (is_time_up())
+            status = "timeout";
+
+        std::cout << "r graph=" << g->graph_name << " lb=" << best_lb << " ub=" << best_ub << " status=" << status;
+        std::cout << " labelling_abw=" << best_labels_abw << " labelling=";
+        if (best_labels.empty())
+            std::cout << "none";
+        for (unsigned node = 0; node < best_labels.size(); ++node)
+        {
+            std::cout << (node ? "," : "") << best_labels[node];
+        }
+        std::cout << std::endl;
+    };
+
+    void AntibandwidthEncoder::record_labelling(const std::vector<int> &labels, int abw)
+    {
+        if (labels.size() != g->n)
             return;
+        if (best_labels.empty() || abw > best_labels_abw)
+        {
+            best_labels = labels;
+            best_labels_abw = abw;
         }
+        best_lb = std::max(best_lb, abw);
+    };
+
+    void AntibandwidthEncoder::record_unsat(int w)
+    {
+        best_ub = std::min(best_ub, w - 1);
+        best_ub_proven = true;
+    };
+
+    void AntibandwidthEncoder::checkpoint_width(int w, int res)
+    {
+        if (!checkpoint)
+            return;
+        if (best_labels_abw > checkpoint_labels_abw)
+        {
+            checkpoint->append_labelling(best_labels_abw, best_labels);
+            checkpoint_labels_abw = best_labels_abw;
+        }
+        checkpoint->append_width(w, res, best_lb, best_ub, solve_budget());
+    };
+
+    /*
+     * Bounds proven by an earlier run narrow the search. The LB width is
+     * probed again (a cheap SAT call), the UNSAT widths above UB are not.
+     */
+    void AntibandwidthEncoder::resume_bounds(int &w_from, int &w_to)
+    {
+        Checkpoint resumed(resume_file, g, encoder_name());
+        if (!resumed.load())
+            return;
+
+        record_labelling(resumed.labels, resumed.labels_abw);
+        if (resumed.lb > 0)
+        {
+            best_lb = std::max(best_lb, resumed.lb);
+            w_from = std::max(w_from, resumed.lb);
+        }
+        if (resumed.ub > 0)
+        {
+            best_ub = std::min(best_ub, resumed.ub);
+            w_to = std::min(w_to, resumed.ub);
+        }
+        resumed_unknown_widths = resumed.unknown_widths;
+        std::cout << "c Resumed from " << resume_file << ": LB-w = " << w_from << ", UB-w = " << w_to;
+        std::cout << ", " << resumed_unknown_widths.size() << " unknown widths." << std::endl;
+    };
+
+    std::string AntibandwidthEncoder::encoder_name() const
+    {
+        switch (enc_choice)
+        {
+        case duplex:
+            return "duplex";
+        case reduced:
+            return "reduced";
+        case seq:
+            return "seq";
+        case product:
+            return "product";
+        case ladder:
+            return "ladder";
+        case order:
+            return "order";
+        default:
+            return "unknown";
+        }
+    };
+
+    WidthBudget AntibandwidthEncoder::solve_budget() const
+    {
+        WidthBudget budget = active_budget;
+        budget.deadline = run_deadline;
+        return budget;
+    };
+
+    // An interrupted run stops like one out of time.
+    bool AntibandwidthEncoder::is_time_up() const
+    {
+        if (interrupt_requested.load(std::memory_order_relaxed))
+            return true;
+        return run_deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= run_deadline;
+    };
+
+    std::string AntibandwidthEncoder::stop_reason() const
+    {
+        return interrupt_requested.load(std::memory_order_relaxed) ? "a signal" : "the time limit";
     };
 
     void AntibandwidthEncoder::encode_and_solve_abw_problems(int start_w, int step, int prev_res, int stop_w)
@@ -51,6 +258,14 @@ namespace SATABP
             if (SAT_res != prev_res)
                 break; // reached UNSAT->SAT or SAT->UNSAT point
             prev_res = SAT_res;
+
+            // The model may already be better than asked, every width up to its antibandwidth is SAT.
+            if (SAT_res == 10 && step > 0 && sat_abw > w)
+            {
+                int jump_w = std::min(sat_abw, std::min(stop_w, w_cap) - 1);
+                std::cout << "c Proven LB = " << sat_abw << " by the found labelling, skipping widths " << w + 1 << ".." << jump_w << "." << std::endl;
+                w = jump_w;
+            }
         }
     };
 
@@ -72,7 +287,11 @@ namespace SATABP
     {
         int w_from, w_to;
         setup_bounds(w_from, w_to);
+        bin_search_between(w_from, w_to);
+    };
 
+    void AntibandwidthEncoder::bin_search_between(int w_from, int w_to)
+    {
         int candidate_w = w_from;
 
         while (w_from <= w_to)
@@ -81,7 +300,9 @@ namespace SATABP
             encode_and_solve_antibandwidth_problem(candidate_w);
             if (SAT_res == 10)
             {
-                w_from = candidate_w + 1;
+                w_from = std::max(candidate_w, sat_abw) + 1;
+                if (sat_abw > candidate_w)
+                    std::cout << "c Proven LB = " << sat_abw << " by the found labelling." << std::endl;
             }
             else if (SAT_res == 20)
             {
@@ -94,6 +315,365 @@ namespace SATABP
         }
     };
 
+    /*
+     * Probes LB, then the widths 1, 2, 4, ... above the last SAT width until
+     * the first UNSAT one, and bisects the remaining gap. Only one or two
+     * UNSAT widths far above the optimum are solved.
+     */
+    void AntibandwidthEncoder::encode_and_solve_abw_problems_galloping()
+    {
+        int w_from, w_to;
+        setup_bounds(w_from, w_to);
+
+        int sat_w = w_from - 1;
+        int unsat_w = w_to + 1;
+        int w = w_from;
+        for (int step = 1; w < unsat_w; step *= 2)
+        {
+            bool error = encode_and_solve_antibandwidth_problem(w);
+            if (error || SAT_res == 0)
+                return;
+            if (SAT_res == 20)
+            {
+                unsat_w = w;
+                break;
+            }
+            sat_w = std::max(w, sat_abw);
+            w = std::min(sat_w + step, w_to);
+            if (sat_w >= w_to)
+                return;
+        }
+
+        std::cout << "c Galloping stopped with SAT w = " << sat_w << " and UNSAT w = " << unsat_w;
+        std::cout << ", bisecting the widths in between." << std::endl;
+        bin_search_between(sat_w + 1, unsat_w - 1);
+    };
+
+    /*
+     * Measures the time of every probed width separately for SAT and UNSAT
+     * answers and picks the next width that minimises the expected time
+     * still needed. Until an UNSAT width is seen, it is assumed to cost ten
+     * times a SAT one.
+     */
+    void AntibandwidthEncoder::encode_and_solve_abw_problems_cost_model()
+    {
+        int w_from, w_to;
+        setup_bounds(w_from, w_to);
+
+        const double unsat_cost_ratio = 10;
+        double sat_ms = 0, unsat_ms = 0;
+        int sat_count = 0, unsat_count = 0;
+
+        int sat_w = w_from - 1;
+        int unsat_w = w_to + 1;
+        while (sat_w + 1 < unsat_w)
+        {
+            double mean_sat_ms = sat_count ? sat_ms / sat_count : (unsat_count ? unsat_ms / unsat_count / unsat_cost_ratio : 1);
+            double mean_unsat_ms = unsat_count ? unsat_ms / unsat_count : mean_sat_ms * unsat_cost_ratio;
+            int w = pick_cost_model_width(sat_w, unsat_w, std::max(mean_sat_ms, 1.0), std::max(mean_unsat_ms, 1.0));
+            std::cout << "c Cost model: SAT width ~" << mean_sat_ms << " ms, UNSAT width ~" << mean_unsat_ms << " ms, next w = " << w << "." << std::endl;
+
+            auto t1 = std::chrono::high_resolution_clock::now();
+            bool error = encode_and_solve_antibandwidth_problem(w);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            double width_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+            if (error || SAT_res == 0)
+                return;
+
+            if (SAT_res == 10)
+            {
+                sat_ms += width_ms;
+                sat_count++;
+                sat_w = std::max(w, sat_abw);
+            }
+            else
+            {
+                unsat_ms += width_ms;
+                unsat_count++;
+                unsat_w = w;
+            }
+        }
+    };
+
+    /*
+     * The optimum is taken as uniformly distributed over sat_w..unsat_w-1,
+     * so the expected cost of an open gap only depends on its length and
+     * is computed bottom up for every length, in O(gap^2).
+     */
+    int AntibandwidthEncoder::pick_cost_model_width(int sat_w, int unsat_w, double sat_ms, double unsat_ms) const
+    {
+        int gap = unsat_w - sat_w - 1;
+        std::vector<double> expected(gap + 1, 0);
+        std::vector<int> offset(gap + 1, 1);
+        for (int len = 1; len <= gap; ++len)
+        {
+            expected[len] = -1;
+            for (int k = 1; k <= len; ++k)
+            {
+                double p_sat = double(len - k + 1) / (len + 1);
+                double cost = p_sat * (sat_ms + expected[len - k]) + (1 - p_sat) * (unsat_ms + expected[k - 1]);
+                if (expected[len] < 0 || cost < expected[len])
+                {
+                    expected[len] = cost;
+                    offset[len] = k;
+                }
+            }
+        }
+        return sat_w + offset[gap];
+    };
+
+    /*
+     * Widths that run out of budget are recorded as unknown and the search
+     * goes on among the other open widths. Once only unknown widths are
+     * left, they are retried with budget_growth times the budget, at most
+     * budget_retries times. The proven bounds are printed in the end.
+     */
+    void AntibandwidthEncoder::encode_and_solve_abw_problems_with_budget()
+    {
+        int w_from, w_to;
+        setup_bounds(w_from, w_to);
+
+        int sat_w = w_from - 1;
+        int unsat_w = w_to + 1;
+        std::set<int> unknown_widths;
+        active_budget = width_budget;
+
+        // Resumed unknown widths wait for the first retry, which starts from the largest budget spent on them.
+        WidthBudget retry_budget = width_budget;
+        for (const std::pair<const int, WidthBudget> &resumed : resumed_unknown_widths)
+        {
+            if (resumed.first <= sat_w || resumed.first >= unsat_w)
+                continue;
+            unknown_widths.insert(resumed.first);
+            if (retry_budget.conflicts >= 0)
+                retry_budget.conflicts = std::max(retry_budget.conflicts, resumed.second.conflicts);
+            if (retry_budget.decisions >= 0)
+                retry_budget.decisions = std::max(retry_budget.decisions, resumed.second.decisions);
+            if (retry_budget.seconds > 0)
+                retry_budget.seconds = std::max(retry_budget.seconds, resumed.second.seconds);
+        }
+
+        for (int round = 0; round <= budget_retries && sat_w + 1 < unsat_w; ++round)
+        {
+            if (round > 0)
+            {
+                active_budget = (round == 1 ? retry_budget : active_budget).scaled(budget_growth);
+                std::cout << "c Retrying " << unknown_widths.size() << " unknown widths with " << active_budget.describe() << "." << std::endl;
+                unknown_widths.clear();
+            }
+
+            int w;
+            while (pick_budgeted_width(sat_w, unsat_w, unknown_widths, w))
+            {
+                bool error = encode_and_solve_antibandwidth_problem(w);
+                if (error)
+                {
+                    active_budget = WidthBudget();
+                    return;
+                }
+
+                if (SAT_res == 10)
+                {
+                    sat_w = std::max(w, sat_abw);
+                    unknown_widths.erase(unknown_widths.begin(), unknown_widths.upper_bound(sat_w));
+                }
+                else if (SAT_res == 20)
+                {
+                    unsat_w = w;
+                    unknown_widths.erase(unknown_widths.lower_bound(unsat_w), unknown_widths.end());
+                }
+                else
+                {
+                    unknown_widths.insert(w);
+                }
+            }
+        }
+        active_budget = WidthBudget();
+
+        std::cout << "c Proven bounds: LB = " << sat_w << ", UB = " << unsat_w - 1;
+        if (!unknown_widths.empty())
+        {
+            std::cout << ", unknown widths:";
+            for (int unknown_w : unknown_widths)
+                std::cout << " " << unknown_w;
+        }
+        std::cout << "." << std::endl;
+    };
+
+    /*
+     * Picks an open width that is not unknown in the order of the chosen
+     * strategy: lowest first, highest first, or else the middle of the
+     * largest run of open widths between the bounds and the unknown ones.
+     */
+    bool AntibandwidthEncoder::pick_budgeted_width(int sat_w, int unsat_w, const std::set<int> &unknown_widths, int &w) const
+    {
+        std::vector<int> blocked{sat_w};
+        blocked.insert(blocked.end(), unknown_widths.begin(), unknown_widths.end());
+        blocked.push_back(unsat_w);
+
+        int best_run = 0;
+        for (unsigned i = 0; i + 1 < blocked.size(); ++i)
+        {
+            int run = blocked[i + 1] - blocked[i] - 1;
+            if (run <= 0)
+                continue;
+            if (enc_strategy == from_lb)
+            {
+                w = blocked[i] + 1;
+                return true;
+            }
+            if (enc_strategy == from_ub)
+            {
+                w = blocked[i + 1] - 1;
+                best_run = run; // the last run wins
+                continue;
+            }
+            if (run > best_run)
+            {
+                best_run = run;
+                w = (blocked[i] + blocked[i + 1]) / 2;
+            }
+        }
+        return best_run > 0;
+    };
+
+    void AntibandwidthEncoder::encode_and_solve_abw_problems_parallel()
+    {
+        int w_from, w_to;
+        setup_bounds(w_from, w_to);
+
+        int threads = thread_count;
+        if (threads < 1)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, w_to - w_from + 1);
+        std::cout << "c Probing widths " << w_from << ".." << w_to << " on " << threads << " threads." << std::endl;
+
+        BoundBoard board(w_from, w_to);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back(&AntibandwidthEncoder::parallel_probe_worker, this, std::ref(board));
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+
+        if (board.is_aborted())
+        {
+            if (is_time_up())
+                std::cout << "c Parallel probing stopped by " << stop_reason() << "." << std::endl;
+            else
+                std::cout << "c Parallel probing aborted after an error." << std::endl;
+            return;
+        }
+        std::cout << "c Parallel probing finished: largest SAT width = " << board.sat_bound();
+        std::cout << ", smallest UNSAT width = " << board.unsat_bound() << "." << std::endl;
+    };
+
+    void AntibandwidthEncoder::parallel_probe_worker(BoundBoard &board)
+    {
+        int w;
+        while (board.next_width(w))
+        {
+            int sat_width = w;
+            int res = probe_width(w, board, sat_width);
+            board.report(w, res, sat_width);
+        }
+    };
+
+    /*
+     * Encodes and solves one width on a solver of its own. The solve is
+     * terminated as soon as other threads have made the width irrelevant.
+     */
+    int AntibandwidthEncoder::probe_width(int w, BoundBoard &board, int &sat_width)
+    {
+        if (w < 2)
+        {
+            std::lock_guard<std::mutex> lock(log_mutex);
+            std::cout << "s SAT (w = " << w << ")" << std::endl;
+            return 10;
+        }
+
+        CaDiCaL::Solver probe_solver;
+        configure_cadical(&probe_solver, false);
+        VarHandler probe_vh(1, g->n);
+        CadicalClauseContainer probe_cc(&probe_vh, split_limit, &probe_solver);
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        Encoder *probe_enc = create_encoder(&probe_cc, &probe_vh);
+        probe_enc->encode_antibandwidth(w, g->edges);
+        delete probe_enc;
+        auto t2 = std::chrono::high_resolution_clock::now();
+        auto encode_duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+        int res = 0;
+        if (!board.is_irrelevant(w))
+        {
+            WidthTerminator width_terminator(board, w);
+            DeadlineTerminator terminator(solve_budget(), &width_terminator);
+            probe_solver.connect_terminator(&terminator);
+            t1 = std::chrono::high_resolution_clock::now();
+            res = probe_solver.solve();
+            t2 = std::chrono::high_resolution_clock::now();
+            probe_solver.disconnect_terminator();
+        }
+        auto solving_duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+        int solution_abw = 0;
+        std::vector<int> node_labels;
+        if (res == 10)
+        {
+            if (extract_node_labels(&probe_solver, node_labels))
+                solution_abw = g->calculate_antibandwidth(node_labels);
+            // A better model proves SAT for every width up to its antibandwidth.
+            sat_width = std::max(w, solution_abw);
+        }
+
+        std::lock_guard<std::mutex> lock(log_mutex);
+        std::cout << "c Width " << w << ": " << probe_cc.size() << " clauses, " << probe_vh.size() << " variables, ";
+        std::cout << "encoding " << encode_duration << " ms, solving " << solving_duration << " ms." << std::endl;
+        if (res == 10)
+        {
+            std::cout << "s SAT (w = " << w << ")" << std::endl;
+            if (check_solution)
+            {
+                std::cout << "p calculated antibandwidth = " << solution_abw << "." << std::endl;
+                if (solution_abw < w)
+                {
+                    std::cerr << "c Error, the solution is not correct, antibandwidth should be at least " << w << ", but it is " << solution_abw << "." << std::endl;
+                    board.abort();
+                    return 0;
+                }
+            }
+            if (sat_width > w)
+                std::cout << "c Proven LB = " << sat_width << " by the found labelling." << std::endl;
+            record_labelling(node_labels, solution_abw);
+            checkpoint_width(w, res);
+        }
+        else if (res == 20)
+        {
+            std::cout << "s UNSAT (w = " << w << ")" << std::endl;
+            record_unsat(w);
+            checkpoint_width(w, res);
+        }
+        else if (board.is_irrelevant(w))
+        {
+            std::cout << "c Width " << w << " cancelled, it is decided by the current bounds." << std::endl;
+        }
+        else if (is_time_up())
+        {
+            std::cout << "c Width " << w << " stopped by " << stop_reason() << "." << std::endl;
+            board.abort();
+        }
+        else
+        {
+            std::cout << "s Error at w = " << w << ", SAT result: " << res << std::endl;
+            board.abort();
+        }
+        return res;
+    };
+
     bool AntibandwidthEncoder::encode_and_solve_antibandwidth_problem(int w)
     {
         std::cout << "c Antibandwidth problem with w = " << w << " ( " << g->graph_name << " ):" << std::endl;
@@ -107,25 +687,52 @@ namespace SATABP
         {
             std::cout << "c There is always at least 1 distance in any labelling. There is nothing to encode here." << std::endl;
             SAT_res = 10; // check solution can not be invoked
+            sat_abw = w;
             return 0;
         }
 
-        setup_for_solving();
+        if (is_time_up())
+        {
+            std::cout << "c Stopped by " << stop_reason() << ", w = " << w << " is not solved." << std::endl;
+            SAT_res = 0;
+            return 1;
+        }
+
+        if (!incremental)
+            setup_for_solving();
         std::cout << "c Encoding starts with w = " << w << ":" << std::endl;
 
+        unsigned clauses_before = cc->size();
         auto t1 = std::chrono::high_resolution_clock::now();
-        enc->encode_antibandwidth(w, g->edges);
+        if (incremental)
+        {
+            // Width clauses are only active while the selector is assumed.
+            width_selector = vh->get_new_var();
+            cc->set_activation_literal(width_selector);
+            enc->encode_width_part(w, g->edges);
+            cc->set_activation_literal(0);
+        }
+        else
+        {
+            enc->encode_antibandwidth(w, g->edges);
+        }
         auto t2 = std::chrono::high_resolution_clock::now();
         auto encode_duration = std::chrono::duration_cast<std::chrono::seconds>(t2 - t1).count();
 
         std::cout << "c\tEncoding duration: " << encode_duration << "s" << std::endl;
-        std::cout << "c\tNumber of clauses: " << cc->size() << std::endl;
+        std::cout << "c\tNumber of clauses: " << cc->size() - clauses_before << std::endl;
         std::cout << "c\tNumber of irredundant clauses: " << solver->irredundant() << std::endl;
         std::cout << "c\tNumber of variables: " << vh->size() << std::endl;
+        if (transfer)
+        {
+            unsigned injected = transfer->inject(solver, w);
+            std::cout << "c\tClause transfer: " << injected << " of " << transfer->pool_size() << " pooled clauses added." << std::endl;
+            transfer->mark_originals(solver);
+        }
         std::cout << "c SAT Solving starts:" << std::endl;
 
         t1 = std::chrono::high_resolution_clock::now();
-        SAT_res = solver->solve();
+        SAT_res = solve_width();
         t2 = std::chrono::high_resolution_clock::now();
         auto solving_duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
         std::cout << "c\tSolving duration: " << solving_duration << " ms" << std::endl;
@@ -135,57 +742,243 @@ namespace SATABP
             std::cout << "s SAT (w = " << w << ")" << std::endl;
         }
         else if (SAT_res == 20)
+        {
             std::cout << "s UNSAT (w = " << w << ")" << std::endl;
+            record_unsat(w);
+        }
+        else if (is_time_up())
+        {
+            std::cout << "c Solving w = " << w << " was stopped by " << stop_reason() << "." << std::endl;
+            finish_width();
+            return 1;
+        }
+        else if (active_budget.is_limited())
+        {
+            std::cout << "s UNKNOWN (w = " << w << ")" << std::endl;
+            std::cout << "c Width " << w << " ran out of its budget (" << active_budget.describe() << ")." << std::endl;
+            checkpoint_width(w, 0);
+            finish_width();
+            std::cout << "c" << std::endl
+                      << "c" << std::endl;
+            return 0;
+        }
         else
         {
             std::cout << "s Error at w = " << w << ", SAT result: " << SAT_res << std::endl;
-            cleanup_solving();
+            finish_width();
             return 1;
         }
 
-        if (check_solution && SAT_res == 10)
+        // An UNSAT width has nothing to give to the larger widths.
+        if (transfer && SAT_res == 10)
+        {
+            unsigned harvested = transfer->harvest(model_solver, w);
+            std::cout << "c\tClause transfer: " << harvested << " new label-only clauses harvested." << std::endl;
+        }
+
+        if (SAT_res == 10)
         {
             int solution_abw = calculate_sat_solution();
-            if (solution_abw < w)
+            sat_abw = std::max(w, solution_abw);
+            if (check_solution && solution_abw < w)
             {
                 std::cerr << "c Error, the solution is not correct, antibandwidth should be at least " << w << ", but it is " << solution_abw << "." << std::endl;
 
-                cleanup_solving();
+                finish_width();
                 return 1;
             }
         }
+        checkpoint_width(w, SAT_res);
 
-        cleanup_solving();
+        finish_width();
 
         std::cout << "c" << std::endl
                   << "c" << std::endl;
         return 0;
     };
 
+    int AntibandwidthEncoder::solve_width()
+    {
+        std::vector<int> assumptions;
+        if (incremental)
+            assumptions.push_back(width_selector);
+
+        if (seed_phases)
+        {
+            int res = solve_seeded(assumptions);
+            if (res != 0)
+            {
+                model_solver = solver;
+                return res;
+            }
+        }
+
+        if (portfolio_size > 1)
+        {
+            std::cout << "c\tCloning the formula into a portfolio of " << portfolio_size << " solvers." << std::endl;
+            portfolio = new SolverPortfolio(solver, portfolio_size, sat_configuration, verbose);
+            int res = portfolio->solve(assumptions, solve_budget());
+            model_solver = portfolio->winner();
+            return res;
+        }
+
+        for (int lit : assumptions)
+        {
+            solver->assume(lit);
+        }
+        model_solver = solver;
+        WidthBudget budget = solve_budget();
+        budget.apply_limits(solver);
+        DeadlineTerminator terminator(budget);
+        solver->connect_terminator(&terminator);
+        int res = solver->solve();
+        solver->disconnect_terminator();
+        return res;
+    };
+
+    /*
+     * This CaDiCaL has no API to set decision phases, so the seed labelling
+     * is assumed instead, with a conflict limit. Seed literals in the failed
+     * core are dropped and the rest is tried again. An UNSAT answer counts
+     * only if no seed literal took part in it. Without an answer the solver
+     * still keeps the saved phases of the seeded search for the free solve.
+     */
+    int AntibandwidthEncoder::solve_seeded(const std::vector<int> &assumptions)
+    {
+        const std::vector<int> &seed = seed_labels.empty() ? heuristic_labels : seed_labels;
+        if (seed.size() != g->n)
+            return 0;
+
+        std::vector<int> seed_lits;
+        for (unsigned node = 0; node < g->n; ++node)
+        {
+            seed_lits.push_back(node * g->n + seed[node]);
+        }
+
+        for (int round = 1; round <= seed_rounds && !seed_lits.empty(); ++round)
+        {
+            for (int lit : assumptions)
+                solver->assume(lit);
+            for (int lit : seed_lits)
+                solver->assume(lit);
+            solver->limit("conflicts", seed_conflicts);
+            WidthBudget run_budget;
+            run_budget.deadline = run_deadline;
+            DeadlineTerminator terminator(run_budget);
+            solver->connect_terminator(&terminator);
+            int res = solver->solve();
+            solver->disconnect_terminator();
+
+            if (res == 10)
+            {
+                std::cout << "c\tSeeded solve found a model in round " << round << " (" << seed_lits.size() << " seed literals)." << std::endl;
+                return 10;
+            }
+            if (res != 20)
+                break;
+
+            std::vector<int> kept_lits;
+            for (int lit : seed_lits)
+            {
+                if (!solver->failed(lit))
+                    kept_lits.push_back(lit);
+            }
+            if (kept_lits.size() == seed_lits.size())
+            {
+                std::cout << "c\tSeeded solve proved UNSAT without using the seed." << std::endl;
+                return 20;
+            }
+            seed_lits.swap(kept_lits);
+        }
+
+        std::cout << "c\tSeeded solve gave no answer, solving without seed." << std::endl;
+        return 0;
+    };
+
     void AntibandwidthEncoder::encode_and_print_abw_problem(int w)
     {
+        int vars = 0;
+        unsigned clauses = 0;
         setup_for_print();
+        if (!dimacs_writer->is_open())
+        {
+            std::cout << "c Error, could not write DIMACS file '" << dimacs_file << "'." << std::endl;
+            cleanup_print();
+            return;
+        }
+        if (!dimacs_writer->can_patch_header())
+        {
+            // The header cannot be rewritten at the end, so count the formula in a first pass.
+            std::cout << "c Output is not seekable, counting the formula first." << std::endl;
+            VarHandler count_vh(1, g->n);
+            DimacsWriter counter(&count_vh, split_limit, "", true);
+            Encoder *count_enc = create_encoder(&counter, &count_vh);
+            count_enc->encode_antibandwidth(w, g->edges);
+            vars = count_vh.size();
+            clauses = counter.size();
+            delete count_enc;
+        }
 
+        dimacs_writer->begin(vars, clauses);
         enc->encode_antibandwidth(w, g->edges);
-        cc->print_dimacs();
+        dimacs_writer->finish();
 
         cleanup_print();
     };
 
     void AntibandwidthEncoder::setup_bounds(int &w_from, int &w_to)
     {
+        std::string lb_source = "predefined";
+        std::string ub_source = "predefined";
+        auto note_sources = [&](int prev_lb, int prev_ub, const std::string &source)
+        {
+            if (w_from != prev_lb)
+                lb_source = source;
+            if (w_to != prev_ub)
+                ub_source = source;
+        };
+
         lookup_bounds(w_from, w_to);
+        int prev_lb = w_from, prev_ub = w_to;
+        if (!bounds_db_file.empty())
+        {
+            lookup_bounds_db(w_from, w_to);
+            note_sources(prev_lb, prev_ub, "bounds database");
+        }
+        if (structural_bounds)
+        {
+            prev_lb = w_from, prev_ub = w_to;
+            apply_structural_bounds(w_from, w_to);
+            note_sources(prev_lb, prev_ub, "structural");
+        }
+        best_lb = std::max(best_lb, w_from);
+        best_ub = w_to;
+        if (heuristic_lb)
+        {
+            prev_lb = w_from, prev_ub = w_to;
+            raise_lb_by_heuristics(w_from);
+            note_sources(prev_lb, prev_ub, "heuristic");
+        }
+        if (!resume_file.empty())
+        {
+            prev_lb = w_from, prev_ub = w_to;
+            resume_bounds(w_from, w_to);
+            note_sources(prev_lb, prev_ub, "checkpoint");
+        }
 
         if (overwrite_lb)
         {
             std::cout << "c LB " << w_from << " is overwritten with " << forced_lb << "." << std::endl;
             w_from = forced_lb;
+            lb_source = "user";
         }
         if (overwrite_ub)
         {
             std::cout << "c UB " << w_to << " is overwritten with " << forced_ub << "." << std::endl;
             w_to = forced_ub;
+            ub_source = "user";
         }
+        std::cout << "c Bounds: LB-w = " << w_from << " (" << lb_source << "), UB-w = " << w_to << " (" << ub_source << ")." << std::endl;
         if (w_from > w_to)
         {
             int tmp = w_from;
@@ -198,6 +991,46 @@ namespace SATABP
         assert((w_from <= w_to) && (w_from >= 1));
     };
 
+    void AntibandwidthEncoder::apply_structural_bounds(int &lb, int &ub)
+    {
+        StructuralBounds bounds(g);
+        bounds.run();
+
+        if (bounds.lower_bound() > lb)
+        {
+            lb = bounds.lower_bound();
+            std::cout << "c LB-w = " << lb << " (structural: " << bounds.lower_source() << ")." << std::endl;
+        }
+        if (bounds.upper_bound() > 0 && bounds.upper_bound() < ub)
+        {
+            ub = bounds.upper_bound();
+            best_ub_proven = true;
+            std::cout << "c UB-w = " << ub << " (structural: " << bounds.upper_source() << ")." << std::endl;
+        }
+    };
+
+    void AntibandwidthEncoder::raise_lb_by_heuristics(int &lb)
+    {
+        std::cout << "c Running labelling heuristics:" << std::endl;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        LabellingHeuristics heuristics(g);
+        int heuristic_abw = heuristics.run();
+        auto t2 = std::chrono::high_resolution_clock::now();
+        auto heuristic_duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        std::cout << "c\tHeuristics duration: " << heuristic_duration << " ms" << std::endl;
+
+        heuristic_labels = heuristics.best_labelling();
+        record_labelling(heuristic_labels, heuristic_abw);
+        if (!heuristic_labelling_file.empty() && heuristics.write_labelling(heuristic_labelling_file))
+            std::cout << "c\tBest heuristic labelling written to " << heuristic_labelling_file << "." << std::endl;
+
+        if (heuristic_abw > lb)
+        {
+            std::cout << "c LB-w = " << heuristic_abw << " (labelling heuristic: " << heuristics.best_variant() << ")." << std::endl;
+            lb = heuristic_abw;
+        }
+    };
+
     void AntibandwidthEncoder::lookup_bounds(int &lb, int &ub)
     {
         auto pos = abw_LBs.find(g->graph_name);
@@ -217,6 +1050,7 @@ namespace SATABP
         if (pos != abw_UBs.end())
         {
             ub = pos->second;
+            best_ub_proven = true;
             if (verbose)
                 std::cout << "c UB-w = " << ub << " (UB in Sinnl - A note on computational approaches for the antibandwidth problem)." << std::endl;
         }
@@ -228,6 +1062,41 @@ namespace SATABP
         }
     };
 
+    void AntibandwidthEncoder::lookup_bounds_db(int &lb, int &ub)
+    {
+        BoundsDatabase db(bounds_db_file);
+        std::vector<int> labels;
+        int labels_abw = 0;
+        int table_ub = ub;
+        db_has_record = db.lookup(g, lb, ub, labels, labels_abw);
+        if (!db_has_record)
+        {
+            std::cout << "c No record of " << g->graph_name << " in the bounds database " << bounds_db_file << "." << std::endl;
+            return;
+        }
+
+        record_labelling(labels, labels_abw);
+        if (ub < table_ub)
+            best_ub_proven = true;
+        db_known_lb = lb;
+        db_known_ub = best_ub_proven ? ub : 0;
+        db_known_labels_abw = labels_abw;
+        std::cout << "c LB-w = " << lb << ", UB-w = " << ub << " (bounds database " << bounds_db_file << ")." << std::endl;
+    };
+
+    // Appends a record only if this run proved something the database did not know.
+    void AntibandwidthEncoder::store_bounds_db()
+    {
+        int proven_ub = best_ub_proven ? best_ub : 0;
+        bool better_ub = proven_ub > 0 && (db_known_ub == 0 || proven_ub < db_known_ub);
+        if (db_has_record && best_lb <= db_known_lb && !better_ub && best_labels_abw <= db_known_labels_abw)
+            return;
+
+        BoundsDatabase db(bounds_db_file);
+        db.store(g, best_lb, proven_ub, best_labels);
+        std::cout << "c Bounds LB = " << best_lb << ", UB = " << proven_ub << " stored in " << bounds_db_file << "." << std::endl;
+    };
+
     void AntibandwidthEncoder::setup_for_solving()
     {
         setup_cadical();
@@ -237,6 +1106,38 @@ namespace SATABP
         setup_encoder();
     };
 
+    void AntibandwidthEncoder::setup_for_incremental_solving()
+    {
+        setup_for_solving();
+        std::cout << "c Incremental solving: width-independent constraints are encoded once." << std::endl;
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        enc->encode_labelling_part();
+        auto t2 = std::chrono::high_resolution_clock::now();
+        auto encode_duration = std::chrono::duration_cast<std::chrono::seconds>(t2 - t1).count();
+
+        std::cout << "c\tEncoding duration: " << encode_duration << "s" << std::endl;
+        std::cout << "c\tNumber of clauses: " << cc->size() << std::endl;
+        std::cout << "c" << std::endl;
+    };
+
+    void AntibandwidthEncoder::finish_width()
+    {
+        delete portfolio;
+        portfolio = nullptr;
+        model_solver = nullptr;
+
+        if (!incremental)
+        {
+            cleanup_solving();
+            return;
+        }
+
+        // Permanently disable the clauses of this width, the solver can drop them.
+        cc->add_clause(-1 * width_selector);
+        width_selector = 0;
+    };
+
     void AntibandwidthEncoder::cleanup_solving()
     {
         delete enc;
@@ -248,7 +1149,8 @@ namespace SATABP
     void AntibandwidthEncoder::setup_for_print()
     {
         vh = new VarHandler(1, g->n);
-        cc = new ClauseVector(vh, split_limit);
+        dimacs_writer = new DimacsWriter(vh, split_limit, dimacs_file);
+        cc = dimacs_writer;
 
         setup_encoder();
     };
@@ -257,6 +1159,7 @@ namespace SATABP
     {
         delete enc;
         delete cc;
+        dimacs_writer = nullptr;
         delete vh;
     };
 
@@ -267,8 +1170,13 @@ namespace SATABP
 
         std::cout << "(version " << solver->version() << ")." << std::endl;
 
-        auto res = solver->configure(sat_configuration.data());
-        if (verbose)
+        configure_cadical(solver, verbose);
+    };
+
+    void AntibandwidthEncoder::configure_cadical(CaDiCaL::Solver *s, bool log) const
+    {
+        auto res = s->configure(sat_configuration.data());
+        if (log)
             std::cout << "c\tConfiguring CaDiCaL as --" << sat_configuration << " (" << res << ")." << std::endl;
 
         if (force_phase)
@@ -276,8 +1184,8 @@ namespace SATABP
             std::vector<std::string> force_phase_options{"--forcephase", "--phase=0", "--no-rephase"};
             for (unsigned i = 0; i < force_phase_options.size(); ++i)
             {
-                res = solver->set_long_option(force_phase_options[i].data());
-                if (verbose)
+                res = s->set_long_option(force_phase_options[i].data());
+                if (log)
                     std::cout << "c\tCaDiCaL option " << force_phase_options[i] << " added (" << res << ")" << std::endl;
             }
         }
@@ -285,37 +1193,49 @@ namespace SATABP
 
     void AntibandwidthEncoder::setup_encoder()
     {
+        enc = create_encoder(cc, vh);
+    };
+
+    Encoder *AntibandwidthEncoder::create_encoder(ClauseContainer *clause_container, VarHandler *var_handler) const
+    {
+        Encoder *new_enc;
         switch (enc_choice)
         {
         case duplex:
             std::cout << "c Initializing a Duplex encoder with n = " << g->n << "." << std::endl;
-            enc = new DuplexEncoder(g, cc, vh);
-            enc->symmetry_break_point = symmetry_break_point;
+            new_enc = new_sink_encoder<DuplexEncoder>(g, clause_container, var_handler);
             break;
         case reduced:
             std::cout << "c Initializing a Naive-Reduced encoder with n = " << g->n << "." << std::endl;
-            enc = new ReducedEncoder(g, cc, vh);
-            enc->symmetry_break_point = symmetry_break_point;
+            new_enc = new ReducedEncoder(g, clause_container, var_handler);
             break;
         case seq:
             std::cout << "c Initializing a Sequential encoder with n = " << g->n << "." << std::endl;
-            enc = new SeqEncoder(g, cc, vh);
-            enc->symmetry_break_point = symmetry_break_point;
+            new_enc = new SeqEncoder(g, clause_container, var_handler);
             break;
         case product:
             std::cout << "c Initializing a 2-Product encoder with n = " << g->n << "." << std::endl;
-            enc = new ProductEncoder(g, cc, vh);
-            enc->symmetry_break_point = symmetry_break_point;
+            new_enc = new ProductEncoder(g, clause_container, var_handler);
             break;
         case ladder:
             std::cout << "c Initializing a Ladder encoder with n = " << g->n << "." << std::endl;
-            enc = new LadderEncoder(g, cc, vh);
-            enc->symmetry_break_point = symmetry_break_point;
+            new_enc = new_sink_encoder<LadderEncoder>(g, clause_container, var_handler);
+            break;
+        case order:
+            std::cout << "c Initializing an Order encoder with n = " << g->n << "." << std::endl;
+            new_enc = new_sink_encoder<OrderEncoder>(g, clause_container, var_handler);
             break;
         default:
             std::cerr << "c Unrecognized encoder type " << enc_choice << "." << std::endl;
-            return;
+            return nullptr;
         }
+        new_enc->symmetry_break_point = symmetry_break_point;
+        new_enc->encode_threads = encode_threads;
+        new_enc->aggregate_glue = aggregate_glue;
+        new_enc->clique_cover = clique_cover;
+        new_enc->prune_domains = prune_domains;
+        new_enc->prune_rounds = prune_rounds;
+        return new_enc;
     };
 
     int AntibandwidthEncoder::calculate_sat_solution()
@@ -324,21 +1244,25 @@ namespace SATABP
                   << "p calculated antibandwidth = ";
 
         std::vector<int> node_labels = std::vector<int>();
-        if (!extract_node_labels(node_labels))
+        if (!extract_node_labels(model_solver, node_labels))
             return 0;
         int min_dist = g->calculate_antibandwidth(node_labels);
         std::cout << min_dist << "." << std::endl;
+        record_labelling(node_labels, min_dist);
+
+        if (seed_phases && node_labels.size() == g->n)
+            seed_labels = node_labels;
 
         return min_dist;
     };
 
-    bool AntibandwidthEncoder::extract_node_labels(std::vector<int> &node_labels)
+    bool AntibandwidthEncoder::extract_node_labels(CaDiCaL::Solver *s, std::vector<int> &node_labels) const
     {
         for (unsigned node = 0; node < g->n; ++node)
         {
             for (unsigned label = 1; label <= g->n; ++label)
             {
-                int res = solver->val(node * g->n + label);
+                int res = s->val(node * g->n + label);
                 if (res > 0)
                 {
                     node_labels.push_back(label);
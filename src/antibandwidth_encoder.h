@@ -4,6 +4,10 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <set>
+#include <map>
 
 #include "utils.h"
 
@@ -12,9 +16,19 @@
 #include "product_encoder.h"
 #include "duplex_encoder.h"
 #include "ladder_encoder.h"
+#include "order_encoder.h"
 
 #include "clause_cont.h"
+#include "dimacs_writer.h"
 #include "cadical_clauses.h"
+#include "solver_portfolio.h"
+#include "bound_board.h"
+#include "labelling_heuristics.h"
+#include "clause_transfer.h"
+#include "width_budget.h"
+#include "checkpoint.h"
+#include "bounds_db.h"
+#include "structural_bounds.h"
 
 namespace SATABP
 {
@@ -26,12 +40,16 @@ namespace SATABP
     seq,
     product,
     ladder,
+    order,
   };
   enum EncoderStrategy
   {
     from_lb,
     from_ub,
     bin_search,
+    parallel,
+    galloping,
+    cost_model,
   };
 
   class AntibandwidthEncoder
@@ -46,10 +64,19 @@ namespace SATABP
     bool verbose = true;
     bool check_solution = true;
 
+    bool incremental = false;
+    int portfolio_size = 1;
+    int thread_count = 0; // 0: one thread per hardware core
+
     bool force_phase = false;
     std::string sat_configuration = "sat";
 
     int split_limit = 0;
+    unsigned encode_threads = 1;
+    bool aggregate_glue = false;
+    bool clique_cover = false;
+    bool prune_domains = false;
+    unsigned prune_rounds = 10;
     std::string symmetry_break_point = "n";
     int w_cap = 500;
 
@@ -58,39 +85,120 @@ namespace SATABP
     int forced_lb = 0;
     int forced_ub = 0;
 
+    bool structural_bounds = true;
+    bool heuristic_lb = true;
+    std::string heuristic_labelling_file = "";
+
+    bool seed_phases = false;
+    std::string seed_labelling_file = "";
+    int seed_conflicts = 2000;
+    int seed_rounds = 3;
+
+    bool transfer_clauses = false;
+    unsigned transfer_max_size = 8;
+
+    WidthBudget width_budget;
+    double budget_growth = 2;
+    int budget_retries = 3;
+
+    int time_limit = 0; // seconds for the whole search, 0: no limit
+
+    std::string checkpoint_file = "";
+    std::string resume_file = "";
+    std::string bounds_db_file = "";
+    std::string dimacs_file = ""; // -print-w output, stdout if empty
+
     void read_graph(std::string graph_file_name);
     void encode_and_solve_abws();
     void encode_and_print_abw_problem(int w);
+    // One 'r ...' line with the best proven bounds and labelling so far.
+    void print_final_bounds() const;
 
   protected:
     Graph *g;
     VarHandler *vh;
     Encoder *enc;
     ClauseContainer *cc;
+    DimacsWriter *dimacs_writer = nullptr;
     CaDiCaL::Solver *solver;
+    SolverPortfolio *portfolio = nullptr;
+    CaDiCaL::Solver *model_solver = nullptr;
+    ClauseTransfer *transfer = nullptr;
+    WidthBudget active_budget; // budget of the current solve, unlimited outside of budgeted search
 
     int SAT_res = 0;
+    int sat_abw = 0; // antibandwidth of the last SAT model
+    std::vector<int> heuristic_labels;
+    std::vector<int> seed_labels; // last SAT model or the labelling read from file
+    int width_selector = 0;
+    std::mutex log_mutex;
+
+    // Best results of the run, LB and UB are both antibandwidth values.
+    int best_lb = 0;
+    int best_ub = 0;
+    std::vector<int> best_labels;
+    int best_labels_abw = 0;
+    bool best_ub_proven = false; // the default UB n/2+1 is not
+
+    // What the bounds database knew at the start of the run.
+    bool db_has_record = false;
+    int db_known_lb = 0;
+    int db_known_ub = 0;
+    int db_known_labels_abw = 0;
+    std::chrono::steady_clock::time_point run_deadline = std::chrono::steady_clock::time_point::max();
+
+    Checkpoint *checkpoint = nullptr;
+    int checkpoint_labels_abw = 0;
+    std::map<int, WidthBudget> resumed_unknown_widths;
 
   private:
     void encode_and_solve_abw_problems_from_lb();
     void encode_and_solve_abw_problems_from_ub();
     void encode_and_solve_abw_problems_bin_search();
+    void encode_and_solve_abw_problems_parallel();
+    void encode_and_solve_abw_problems_galloping();
+    void encode_and_solve_abw_problems_cost_model();
+    void bin_search_between(int w_from, int w_to);
+    void encode_and_solve_abw_problems_with_budget();
+    bool pick_budgeted_width(int sat_w, int unsat_w, const std::set<int> &unknown_widths, int &w) const;
+    int pick_cost_model_width(int sat_w, int unsat_w, double sat_ms, double unsat_ms) const;
+    void parallel_probe_worker(BoundBoard &board);
+    int probe_width(int w, BoundBoard &board, int &sat_width);
 
     void encode_and_solve_abw_problems(int w_from, int w_to, int prev_res, int stop_w);
     bool encode_and_solve_antibandwidth_problem(int w);
+    int solve_width();
+    int solve_seeded(const std::vector<int> &assumptions);
 
     int calculate_sat_solution();
-    bool extract_node_labels(std::vector<int> &node_labels);
+    bool extract_node_labels(CaDiCaL::Solver *s, std::vector<int> &node_labels) const;
 
     void setup_for_solving();
+    void setup_for_incremental_solving();
+    void finish_width();
     void cleanup_solving();
     void setup_for_print();
     void cleanup_print();
 
+    void record_labelling(const std::vector<int> &labels, int abw);
+    void record_unsat(int w);
+    WidthBudget solve_budget() const;
+    void resume_bounds(int &w_from, int &w_to);
+    void checkpoint_width(int w, int res);
+    std::string encoder_name() const;
+    bool is_time_up() const;
+    std::string stop_reason() const;
+
     void setup_cadical();
+    void configure_cadical(CaDiCaL::Solver *s, bool log) const;
     void setup_encoder();
+    Encoder *create_encoder(ClauseContainer *clause_container, VarHandler *var_handler) const;
     void lookup_bounds(int &lb, int &ub);
+    void lookup_bounds_db(int &lb, int &ub);
+    void store_bounds_db();
     void setup_bounds(int &w_from, int &w_to);
+    void apply_structural_bounds(int &lb, int &ub);
+    void raise_lb_by_heuristics(int &lb);
 
     static std::unordered_map<std::string, int> abw_LBs;
     static std::unordered_map<std::string, int> abw_UBs;
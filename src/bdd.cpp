@@ -8,42 +8,48 @@ namespace SATABP {
 BDD::BDD(int from, int to, bool ub) : bound(ub), i_from(from), i_to(to) {};
 BDD::BDD() : bound(-1), i_from(0), i_to(0) {};
 
-BDDHandler::BDDHandler() {
-    amo_bdds = std::unordered_map<std::pair<int,int>,BDD_id,hash_pair>();
-    amz_bdds = std::unordered_map<std::pair<int,int>,BDD_id,hash_pair>();
-    bdds = std::unordered_map<BDD_id,BDD>();
+BDDHandler::BDDHandler() : BDDHandler(0) {};
+
+BDDHandler::BDDHandler(int var_count, int first_var) : first_var(first_var) {
+    for (int dir = 0; dir < 3; ++dir) {
+        amo_index[dir] = std::vector<int>(var_count, 0);
+        amz_index[dir] = std::vector<int>(var_count, 0);
+    }
 
     BDD false_bdd;
     false_bdd.id = 0;
     false_bdd.i_from = 0;
     false_bdd.i_to = 0;
-    bdds[0] = false_bdd;
+    bdds.push_back(false_bdd);
 };
 
+int BDDHandler::direction(int from, int to) {
+    if (from < to)
+        return 0;
+    return from > to ? 1 : 2;
+};
 
-void BDDHandler::save_amo(BDD& new_bdd) {
-    std::pair<int,int> p = std::pair<int,int>(new_bdd.i_from,new_bdd.i_to);
-    auto pos = amo_bdds.find(p);
-    assert(pos == amo_bdds.end());
+void BDDHandler::save_amo(const BDD& new_bdd) {
+    int& index = amo_index[direction(new_bdd.i_from, new_bdd.i_to)][new_bdd.i_from - first_var];
+    assert(index == 0);
 
-    amo_bdds[p] = new_bdd.id;
-    bdds[new_bdd.id] = new_bdd;
+    index = bdds.size();
+    bdds.push_back(new_bdd);
 };
 
-void BDDHandler::save_amz(BDD& new_bdd) {
-    std::pair<int,int> p = std::pair<int,int>(new_bdd.i_from,new_bdd.i_to);
-    auto pos = amz_bdds.find(p);
-    assert(pos == amz_bdds.end());
+void BDDHandler::save_amz(const BDD& new_bdd) {
+    int& index = amz_index[direction(new_bdd.i_from, new_bdd.i_to)][new_bdd.i_from - first_var];
+    assert(index == 0);
 
-    amz_bdds[p] = new_bdd.id;
-    bdds[new_bdd.id] = new_bdd;
+    index = bdds.size();
+    bdds.push_back(new_bdd);
 };
 
-bool BDDHandler::lookup_amo(const std::pair<int,int>& from_to_pair, BDD_id& id) {
-    auto pos = amo_bdds.find(from_to_pair);
-    if (pos != amo_bdds.end()) {
-        //std::cout << "Found AMO " << pos->second << std::endl;
-        id = pos->second;
+bool BDDHandler::lookup_amo(int from, int to, BDD_id& id) const {
+    int index = amo_index[direction(from, to)][from - first_var];
+    if (index != 0) {
+        assert(bdds[index].i_to == to);
+        id = bdds[index].id;
         return true;
     }
 
@@ -51,11 +57,11 @@ bool BDDHandler::lookup_amo(const std::pair<int,int>& from_to_pair, BDD_id& id)
     return false;
 };
 
-bool BDDHandler::lookup_amz(const std::pair<int,int>& from_to_pair, BDD_id& id) {
-    auto pos = amz_bdds.find(from_to_pair);
-    if (pos != amz_bdds.end()) {
-        //std::cout << "Found AMZ " << pos->second << std::endl;
-        id = pos->second;
+bool BDDHandler::lookup_amz(int from, int to, BDD_id& id) const {
+    int index = amz_index[direction(from, to)][from - first_var];
+    if (index != 0) {
+        assert(bdds[index].i_to == to);
+        id = bdds[index].id;
         return true;
     }
 
@@ -63,21 +69,28 @@ bool BDDHandler::lookup_amz(const std::pair<int,int>& from_to_pair, BDD_id& id)
     return false;
 };
 
-void BDDHandler::print_node(BDD_id id) {
-    BDD bdd = bdds[id];
-    std::cout << "id: " << id << "[" << bdd.i_from << " -- " << bdd.i_to << "] <=" << bdd.bound << " ";
+void BDDHandler::print_node(int index) const {
+    const BDD& bdd = bdds[index];
+    std::cout << "id: " << bdd.id << "[" << bdd.i_from << " -- " << bdd.i_to << "] <=" << bdd.bound << " ";
     std::cout << "(tc: " << bdd.true_child_id << " fc: " << bdd.false_child_id <<  ")" << std::endl;
 };
 
-void BDDHandler::print_bdd(BDD_id id) {
-    print_node(id);
-    if (bdds[id].true_child_id != -1) print_bdd(bdds[id].true_child_id);
-    if (bdds[id].false_child_id != -1) print_bdd(bdds[id].false_child_id);
+// Both children of an inner node cover the interval without its first variable.
+void BDDHandler::print_bdd(int index) const {
+    print_node(index);
+    const BDD& bdd = bdds[index];
+    if (index == 0 || bdd.i_from == bdd.i_to)
+        return;
+
+    int next = bdd.i_from < bdd.i_to ? bdd.i_from + 1 : bdd.i_from - 1;
+    int dir = direction(next, bdd.i_to);
+    if (bdd.bound && amo_index[dir][next - first_var] != 0) print_bdd(amo_index[dir][next - first_var]);
+    if (amz_index[dir][next - first_var] != 0) print_bdd(amz_index[dir][next - first_var]);
 };
 
-void BDDHandler::print_all_bdds() {
-    for (auto& bdd: bdds) {
-        print_node(bdd.second.id);
+void BDDHandler::print_all_bdds() const {
+    for (unsigned index = 0; index < bdds.size(); ++index) {
+        print_node(index);
     }
 };
 
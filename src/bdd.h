@@ -1,29 +1,13 @@
 #ifndef BDD_H
 #define BDD_H
 
-#include <unordered_map>
-#include <utility>
-#include <functional>
-#include <cstdint>
-#include <cstddef>
+#include <vector>
 
 namespace SATABP
 {
 
   typedef int BDD_id;
 
-  struct hash_pair final
-  {
-    template <class TFirst, class TSecond>
-    size_t operator()(const std::pair<TFirst, TSecond> &p) const noexcept
-    {
-      uintmax_t hash = std::hash<TFirst>{}(p.first);
-      hash <<= sizeof(uintmax_t) * 4;
-      hash ^= std::hash<TSecond>{}(p.second);
-      return std::hash<uintmax_t>{}(hash);
-    }
-  };
-
   class BDD
   {
   public:
@@ -39,25 +23,38 @@ namespace SATABP
     int i_to;
   };
 
+  /*
+   * Keeps the BDD nodes in one arena, bdds[0] being the false BDD. Every
+   * node covers the variables from i_from up or down to i_to (or only
+   * i_from), and per bound and direction only one interval starts at a
+   * variable, so the interval lookups are array accesses by i_from.
+   */
   class BDDHandler
   {
   public:
     BDDHandler();
-    std::unordered_map<BDD_id, BDD> bdds;
+    // Variables of the intervals are first_var..first_var+var_count-1.
+    explicit BDDHandler(int var_count, int first_var = 1);
+    std::vector<BDD> bdds;
 
-    void save_amo(BDD &new_bdd);
-    void save_amz(BDD &new_bdd);
+    void save_amo(const BDD &new_bdd);
+    void save_amz(const BDD &new_bdd);
 
-    bool lookup_amo(const std::pair<int, int> &from_to_pair, BDD_id &id);
-    bool lookup_amz(const std::pair<int, int> &from_to_pair, BDD_id &id);
+    bool lookup_amo(int from, int to, BDD_id &id) const;
+    bool lookup_amz(int from, int to, BDD_id &id) const;
 
-    void print_node(BDD_id id);
-    void print_bdd(BDD_id id);
-    void print_all_bdds();
+    void print_node(int index) const;
+    void print_bdd(int index) const;
+    void print_all_bdds() const;
 
   private:
-    std::unordered_map<std::pair<int, int>, BDD_id, hash_pair> amo_bdds;
-    std::unordered_map<std::pair<int, int>, BDD_id, hash_pair> amz_bdds;
+    int first_var = 1;
+    // Arena index of the node starting at a variable, 0 if there is none,
+    // per direction: up, down and single variable.
+    std::vector<int> amo_index[3];
+    std::vector<int> amz_index[3];
+
+    static int direction(int from, int to);
   };
 
 }
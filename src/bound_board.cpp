@@ -0,0 +1,115 @@
+#include "bound_board.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace SATABP
+{
+
+    BoundBoard::BoundBoard(int lb, int ub) : best_sat(lb - 1), min_unsat(ub + 1), aborted(false)
+    {
+        assert(lb <= ub);
+    };
+
+    bool BoundBoard::next_width(int &w)
+    {
+        std::unique_lock<std::mutex> lock(board_mutex);
+        while (!is_closed())
+        {
+            if (pick_width(w))
+            {
+                in_flight.insert(w);
+                return true;
+            }
+            // Every open width is being probed, wait for one of them to finish.
+            board_changed.wait(lock);
+        }
+        return false;
+    };
+
+    /*
+     * Splits the largest gap between the bounds and the widths in flight,
+     * so free threads spread over the open range like a k-ary search.
+     */
+    bool BoundBoard::pick_width(int &w) const
+    {
+        int lo = best_sat;
+        int hi = min_unsat;
+        int best_gap = 1;
+        int prev = lo;
+
+        auto consider = [&](int point)
+        {
+            if (point - prev > best_gap)
+            {
+                best_gap = point - prev;
+                w = (prev + point) / 2;
+            }
+            prev = point;
+        };
+
+        for (int busy : in_flight)
+        {
+            if (busy > lo && busy < hi)
+                consider(busy);
+        }
+        consider(hi);
+
+        return best_gap > 1;
+    };
+
+    void BoundBoard::report(int w, int res, int sat_width)
+    {
+        {
+            std::lock_guard<std::mutex> lock(board_mutex);
+            if (res == 10 && std::max(w, sat_width) > best_sat)
+                best_sat = std::max(w, sat_width);
+            else if (res == 20 && w < min_unsat)
+                min_unsat = w;
+            in_flight.erase(w);
+        }
+        board_changed.notify_all();
+    };
+
+    void BoundBoard::abort()
+    {
+        {
+            std::lock_guard<std::mutex> lock(board_mutex);
+            aborted = true;
+        }
+        board_changed.notify_all();
+    };
+
+    bool BoundBoard::is_irrelevant(int w) const
+    {
+        return aborted || w <= best_sat || w >= min_unsat;
+    };
+
+    bool BoundBoard::is_closed() const
+    {
+        return aborted || best_sat + 1 >= min_unsat;
+    };
+
+    bool BoundBoard::is_aborted() const
+    {
+        return aborted;
+    };
+
+    int BoundBoard::sat_bound() const
+    {
+        return best_sat;
+    };
+
+    int BoundBoard::unsat_bound() const
+    {
+        return min_unsat;
+    };
+
+    WidthTerminator::WidthTerminator(const BoundBoard &bound_board, int width) : board(bound_board), w(width) {};
+
+    bool WidthTerminator::terminate()
+    {
+        return board.is_irrelevant(w);
+    };
+
+}
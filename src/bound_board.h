@@ -0,0 +1,66 @@
+#ifndef BOUND_BOARD_H
+#define BOUND_BOARD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
+#include "cadical.hpp"
+
+namespace SATABP
+{
+
+  /*
+   * Shared LB/UB state of a parallel width search. Antibandwidth is
+   * monotone: SAT at w implies SAT below w, UNSAT at w implies UNSAT above.
+   * Every width w with sat_bound < w < unsat_bound is still open.
+   */
+  class BoundBoard
+  {
+  public:
+    BoundBoard(int lb, int ub);
+
+    BoundBoard(const BoundBoard &) = delete;
+    BoundBoard &operator=(const BoundBoard &) = delete;
+
+    // Blocks until an open width is free to probe; false once the search is closed.
+    bool next_width(int &w);
+    // A SAT answer at w may come with a model proving the larger sat_width.
+    void report(int w, int res, int sat_width);
+    void abort();
+
+    bool is_irrelevant(int w) const;
+    bool is_closed() const;
+    bool is_aborted() const;
+
+    int sat_bound() const;
+    int unsat_bound() const;
+
+  private:
+    std::atomic<int> best_sat;
+    std::atomic<int> min_unsat;
+    std::atomic<bool> aborted;
+
+    std::mutex board_mutex;
+    std::condition_variable board_changed;
+    std::set<int> in_flight;
+
+    bool pick_width(int &w) const;
+  };
+
+  // Stops a solve as soon as the board has decided its width.
+  class WidthTerminator : public CaDiCaL::Terminator
+  {
+  public:
+    WidthTerminator(const BoundBoard &bound_board, int width);
+    bool terminate() final;
+
+  private:
+    const BoundBoard &board;
+    const int w;
+  };
+
+}
+
+#endif
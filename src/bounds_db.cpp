@@ -0,0 +1,99 @@
+#include "bounds_db.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h> //atoi
+
+namespace SATABP
+{
+
+    BoundsDatabase::BoundsDatabase(const std::string &file_name) : file_name(file_name) {};
+
+    bool BoundsDatabase::lookup(const Graph *g, int &lb, int &ub, std::vector<int> &labels, int &labels_abw) const
+    {
+        std::ifstream in(file_name);
+        if (!in.is_open())
+            return false;
+
+        std::string structural_key = g->structural_fingerprint();
+        std::string exact_key = g->fingerprint();
+        bool found = false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream iss(line);
+            std::string record_structural_key, record_exact_key, record_graph, record_labelling;
+            int record_lb, record_ub;
+            if (!(iss >> record_structural_key >> record_exact_key >> record_graph >> record_lb >> record_ub >> record_labelling))
+                continue;
+            if (record_structural_key != structural_key)
+                continue;
+            found = true;
+
+            if (record_exact_key == exact_key)
+            {
+                lb = std::max(lb, record_lb);
+                if (record_ub > 0)
+                    ub = std::min(ub, record_ub);
+            }
+
+            std::vector<int> record_labels;
+            if (parse_labelling(record_labelling, g->n, record_labels))
+            {
+                int abw = g->calculate_antibandwidth(record_labels);
+                lb = std::max(lb, abw);
+                if (abw > labels_abw)
+                {
+                    labels_abw = abw;
+                    labels = record_labels;
+                }
+            }
+        }
+        return found;
+    };
+
+    void BoundsDatabase::store(const Graph *g, int lb, int ub, const std::vector<int> &labels) const
+    {
+        std::ostringstream record;
+        record << g->structural_fingerprint() << " " << g->fingerprint() << " " << g->graph_name << " " << lb << " " << ub << " ";
+        if (labels.empty())
+            record << "none";
+        for (unsigned node = 0; node < labels.size(); ++node)
+        {
+            record << (node ? "," : "") << labels[node];
+        }
+        record << "\n";
+
+        // One write per record, so runs appending at the same time do not interleave lines.
+        std::ofstream out(file_name, std::ios::app);
+        if (!out.is_open())
+        {
+            std::cout << "c Error, could not write bounds database '" << file_name << "'. " << std::endl;
+            return;
+        }
+        out << record.str() << std::flush;
+    };
+
+    // A permutation of 1..n, separated by commas.
+    bool BoundsDatabase::parse_labelling(const std::string &text, unsigned n, std::vector<int> &labels)
+    {
+        if (text == "none")
+            return false;
+
+        std::vector<bool> used(n + 1, false);
+        std::istringstream iss(text);
+        std::string label_text;
+        while (std::getline(iss, label_text, ','))
+        {
+            int label = std::atoi(label_text.c_str());
+            if (label < 1 || label > (int)n || used[label])
+                return false;
+            used[label] = true;
+            labels.push_back(label);
+        }
+        return labels.size() == n;
+    };
+
+}
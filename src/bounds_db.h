@@ -0,0 +1,38 @@
+#ifndef BOUNDS_DB_H
+#define BOUNDS_DB_H
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace SATABP
+{
+
+  /*
+   * On-disk store of proven antibandwidth bounds, shared by all runs. One
+   * record per line, appended after each run that improved on the store:
+   *   <structural fingerprint> <fingerprint> <graph name> <LB> <UB> <l1,...,ln|none>
+   * UB is 0 when no UB was proven. Records are found through the
+   * structural fingerprint. The stored LB and UB are only trusted if the
+   * exact fingerprint matches too; otherwise only the antibandwidth of the
+   * stored labelling, recomputed on this graph, counts.
+   */
+  class BoundsDatabase
+  {
+  public:
+    explicit BoundsDatabase(const std::string &file_name);
+
+    // Tightens lb/ub, and labels/labels_abw if a better labelling is stored. False if nothing was found.
+    bool lookup(const Graph *g, int &lb, int &ub, std::vector<int> &labels, int &labels_abw) const;
+    void store(const Graph *g, int lb, int ub, const std::vector<int> &labels) const;
+
+  private:
+    std::string file_name;
+
+    static bool parse_labelling(const std::string &text, unsigned n, std::vector<int> &labels);
+  };
+
+}
+
+#endif
@@ -7,24 +7,13 @@ namespace SATABP
 {
 
     CadicalClauseContainer::CadicalClauseContainer(VarHandler *v, int split_size, CaDiCaL::Solver *solver)
-        : ClauseContainer(v, split_size)
+        : ClauseSink(v, split_size)
     {
         cad_solver = solver;
     };
 
     CadicalClauseContainer::~CadicalClauseContainer(){};
 
-    void CadicalClauseContainer::do_add_clause(const Clause &c)
-    {
-        for (int lit : c)
-        {
-            cad_solver->add(lit);
-        }
-
-        cad_solver->add(0);
-        clause_counter += 1;
-    };
-
     unsigned CadicalClauseContainer::do_size() const
     {
         // cad_solver->irredundant() != clause_counter. Here the encoding clause size is interesting.
@@ -6,16 +6,24 @@
 
 namespace SATABP {
 
-class CadicalClauseContainer : public ClauseContainer {
+class CadicalClauseContainer final : public ClauseSink<CadicalClauseContainer> {
 public:
   CadicalClauseContainer(VarHandler*, int split_size, CaDiCaL::Solver *solver);
   virtual ~CadicalClauseContainer();
 
 private:
+  friend class ClauseSink<CadicalClauseContainer>;
+
   CaDiCaL::Solver* cad_solver;
   unsigned clause_counter = 0;
 
-  void do_add_clause(const Clause& c) final;
+  void do_add_clause(const int *lits, unsigned size) final
+  {
+    for (unsigned i = 0; i < size; ++i)
+      cad_solver->add(lits[i]);
+    cad_solver->add(0);
+    clause_counter += 1;
+  }
   unsigned do_size() const final;
   void do_print_dimacs() const final;
   void do_print_clauses() const final;
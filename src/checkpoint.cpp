@@ -0,0 +1,128 @@
+#include "checkpoint.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace SATABP
+{
+
+    Checkpoint::Checkpoint(const std::string &file_name, const Graph *graph, const std::string &encoder_name)
+        : file_name(file_name), g(graph), encoder(encoder_name) {};
+
+    bool Checkpoint::load()
+    {
+        std::ifstream in(file_name);
+        if (!in.is_open())
+        {
+            std::cout << "c Error, could not open file '" << file_name << "'. " << std::endl;
+            return false;
+        }
+
+        // Records of other graphs sharing the file are skipped.
+        std::string fingerprint = g->fingerprint();
+        std::string line_encoder;
+        bool matching = false;
+        bool found = false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream iss(line);
+            std::string record;
+            iss >> record;
+            if (record == "g")
+            {
+                std::string line_fingerprint, line_graph;
+                iss >> line_fingerprint >> line_graph >> line_encoder;
+                matching = line_fingerprint == fingerprint;
+                found = found || matching;
+            }
+            else if (!matching)
+            {
+                continue;
+            }
+            else if (record == "b")
+            {
+                // Bounds only tighten, whatever order the runs appended them in.
+                int record_lb = 0, record_ub = 0;
+                iss >> record_lb >> record_ub;
+                lb = std::max(lb, record_lb);
+                if (record_ub > 0)
+                    ub = ub > 0 ? std::min(ub, record_ub) : record_ub;
+            }
+            else if (record == "u" && line_encoder == encoder)
+            {
+                int w;
+                WidthBudget budget;
+                if (iss >> w >> budget.conflicts >> budget.decisions >> budget.seconds)
+                    unknown_widths[w] = budget;
+            }
+            else if (record == "l")
+            {
+                int abw;
+                std::vector<int> line_labels;
+                iss >> abw;
+                for (int label; iss >> label;)
+                    line_labels.push_back(label);
+                if (line_labels.size() == g->n && abw > labels_abw)
+                {
+                    labels_abw = abw;
+                    labels = line_labels;
+                }
+            }
+        }
+        if (!found)
+        {
+            std::cout << "c Checkpoint " << file_name << " has no records of " << g->graph_name << "." << std::endl;
+            return false;
+        }
+
+        // Widths decided since they became unknown are no longer open.
+        for (auto it = unknown_widths.begin(); it != unknown_widths.end();)
+        {
+            if (it->first <= lb || (ub > 0 && it->first > ub))
+                it = unknown_widths.erase(it);
+            else
+                ++it;
+        }
+        return true;
+    };
+
+    void Checkpoint::append_width(int w, int res, int lb, int ub, const WidthBudget &budget)
+    {
+        std::string result = res == 10 ? "sat" : (res == 20 ? "unsat" : "unknown");
+        std::string line = "w " + std::to_string(w) + " " + result + "\nb " + std::to_string(lb) + " " + std::to_string(ub);
+        if (res != 10 && res != 20)
+        {
+            line += "\nu " + std::to_string(w) + " " + std::to_string(budget.conflicts) + " " + std::to_string(budget.decisions);
+            line += " " + std::to_string(budget.seconds);
+        }
+        append_line(line);
+    };
+
+    void Checkpoint::append_labelling(int abw, const std::vector<int> &labels)
+    {
+        std::string line = "l " + std::to_string(abw);
+        for (int label : labels)
+            line += " " + std::to_string(label);
+        append_line(line);
+    };
+
+    void Checkpoint::append_line(const std::string &line)
+    {
+        std::ofstream out(file_name, std::ios::app);
+        if (!out.is_open())
+        {
+            std::cout << "c Error, could not write checkpoint '" << file_name << "'. " << std::endl;
+            return;
+        }
+        if (!header_written)
+        {
+            out << "g " << g->fingerprint() << " " << g->graph_name << " " << encoder << "\n";
+            header_written = true;
+        }
+        out << line << std::endl;
+    };
+
+}
@@ -0,0 +1,56 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "width_budget.h"
+
+namespace SATABP
+{
+
+  /*
+   * Append-only record of a width search, so a killed run loses at most
+   * the width it was solving. One record per line:
+   *   g <fingerprint> <graph name> <encoder>   once per run
+   *   w <w> <sat|unsat|unknown>                every decided width
+   *   b <LB> <UB>                              proven bounds after it
+   *   u <w> <conflicts> <decisions> <seconds>  budget spent on an unknown width
+   *   l <antibandwidth> <l1> ... <ln>          a better labelling
+   * Several graphs may share a file. When loading, the records of the same
+   * graph are combined: the largest LB, the smallest known UB, the best
+   * labelling and the latest budget of every unknown width.
+   */
+  class Checkpoint
+  {
+  public:
+    Checkpoint(const std::string &file_name, const Graph *graph, const std::string &encoder_name);
+
+    // False if the file is missing or has no records of this graph.
+    bool load();
+
+    void append_width(int w, int res, int lb, int ub, const WidthBudget &budget);
+    void append_labelling(int abw, const std::vector<int> &labels);
+
+    // Loaded state, lb/ub are 0 when unknown.
+    int lb = 0;
+    int ub = 0;
+    int labels_abw = 0;
+    std::vector<int> labels;
+    // Only filled if the checkpoint was written with the same encoder.
+    std::map<int, WidthBudget> unknown_widths;
+
+  private:
+    std::string file_name;
+    const Graph *g;
+    std::string encoder;
+    bool header_written = false;
+
+    void append_line(const std::string &line);
+  };
+
+}
+
+#endif
@@ -15,29 +15,58 @@ namespace SATABP
 
     ClauseContainer::~ClauseContainer(){};
 
-    void ClauseContainer::add_clause(const Clause &c)
+    void ClauseContainer::set_activation_literal(int lit)
     {
-        if (!do_split)
+        activation_lit = lit;
+    };
+
+    void ClauseContainer::add_clause(const int *lits, unsigned size)
+    {
+        if (activation_lit != 0)
         {
-            do_add_clause(c);
+            guarded_clause.assign(lits, lits + size);
+            guarded_clause.push_back(-1 * activation_lit);
+            lits = guarded_clause.data();
+            size = guarded_clause.size();
         }
-        else
-        {
-            Clause long_clause = c;
-            while (long_clause.size() > split_size)
-            {
-                int split_var = vh->get_new_var();
 
-                Clause chunk(long_clause.begin(), long_clause.begin() + split_size);
-                chunk.push_back(split_var);
-                do_add_clause(chunk);
+        if (do_split && size > split_size)
+            split_and_add_clause(lits, size);
+        else
+            do_add_clause(lits, size);
+    };
 
-                Clause rest = {-1 * split_var};
-                rest.insert(rest.end(), long_clause.begin() + split_size, long_clause.end());
-                long_clause = rest;
-            }
-            do_add_clause(long_clause);
+    /*
+     * The first chunk takes split_size literals, every further one the
+     * negated split variable of the chunk before and split_size - 1
+     * literals. All but the last chunk end with a new split variable.
+     */
+    void ClauseContainer::split_and_add_clause(const int *lits, unsigned size)
+    {
+        const int *rest = lits;
+        const int *end = lits + size;
+        int carried_lit = 0;
+        while ((carried_lit != 0) + (unsigned)(end - rest) > split_size)
+        {
+            int split_var = vh->get_new_var();
+
+            split_chunk.clear();
+            if (carried_lit != 0)
+                split_chunk.push_back(carried_lit);
+            const int *chunk_end = rest + (split_size - split_chunk.size());
+            split_chunk.insert(split_chunk.end(), rest, chunk_end);
+            split_chunk.push_back(split_var);
+            do_add_clause(split_chunk.data(), split_chunk.size());
+
+            rest = chunk_end;
+            carried_lit = -1 * split_var;
         }
+
+        split_chunk.clear();
+        if (carried_lit != 0)
+            split_chunk.push_back(carried_lit);
+        split_chunk.insert(split_chunk.end(), rest, end);
+        do_add_clause(split_chunk.data(), split_chunk.size());
     };
 
     void ClauseContainer::print_clauses() const
@@ -50,52 +79,53 @@ namespace SATABP
         do_print_dimacs();
     };
 
+    void ClauseContainer::clear()
+    {
+        do_clear();
+    };
+
     unsigned ClauseContainer::size() const
     {
         return do_size();
     };
 
     ClauseVector::ClauseVector(VarHandler *v, int split_size)
-        : ClauseContainer(v, split_size)
+        : ClauseSink(v, split_size){};
+
+    ClauseVector::~ClauseVector(){};
+
+    ClauseView ClauseVector::clause(unsigned i) const
     {
-        clause_list = std::vector<Clause>();
+        const int *data = literals.data();
+        return ClauseView{data + clause_starts[i], data + clause_starts[i + 1]};
     };
 
-    ClauseVector::~ClauseVector(){};
+    ClauseVector::const_iterator ClauseVector::begin() const
+    {
+        return const_iterator(this, 0);
+    };
 
-    void ClauseVector::do_add_clause(const Clause &c)
+    ClauseVector::const_iterator ClauseVector::end() const
     {
-        clause_list.push_back(c);
-        for (auto cl : c)
-        {
-            std::cout << cl << " ";
-        }
-        std::cout << std::endl;
+        return const_iterator(this, size());
     };
 
     unsigned ClauseVector::do_size() const
     {
-        return clause_list.size();
+        return clause_starts.size() - 1;
     };
 
     void ClauseVector::do_print_dimacs() const
     {
         std::cout << "p cnf " << vh->size() << " " << size() << std::endl;
-        for (auto const &c : clause_list)
-        {
-            for (auto const &l : c)
-            {
-                std::cout << l << " ";
-            }
-            std::cout << "0" << std::endl;
-        }
+        do_print_clauses();
     };
 
     void ClauseVector::do_print_clauses() const
     {
-        for (auto const &c : clause_list)
+        for (ClauseView c : *this)
         {
-            for (auto const &l : c)
+            for (int l : c)
             {
                 std::cout << l << " ";
             }
@@ -105,7 +135,8 @@ namespace SATABP
 
     void ClauseVector::do_clear()
     {
-        clause_list.clear();
+        literals.clear();
+        clause_starts.assign(1, 0);
     };
 
 }
@@ -9,6 +9,16 @@ namespace SATABP {
 typedef std::vector<int> Clause;
 typedef std::vector<Clause> Clauses;
 
+// Literals of one stored clause, valid until the container is changed.
+struct ClauseView {
+  const int *first;
+  const int *last;
+
+  const int *begin() const { return first; }
+  const int *end() const { return last; }
+  unsigned size() const { return last - first; }
+};
+
 class ClauseContainer {
 public:
   ClauseContainer(const ClauseContainer &) = delete;
@@ -16,12 +26,19 @@ public:
 
   virtual ~ClauseContainer();
 
-  Clauses clause_list;
-
-  void add_clause(const Clause& c);
+  void add_clause(const Clause& c) { add_clause(c.data(), c.size()); }
+  // Fixed-arity clauses, built on the stack with room for the activation guard.
+  void add_clause(int a) { int lits[2] = {a}; add_fixed_clause(lits, 1); }
+  void add_clause(int a, int b) { int lits[3] = {a, b}; add_fixed_clause(lits, 2); }
+  void add_clause(int a, int b, int c) { int lits[4] = {a, b, c}; add_fixed_clause(lits, 3); }
+  void add_clause(const int *lits, unsigned size);
+  // Guard every following clause with -lit (0 disables the guard).
+  void set_activation_literal(int lit);
   void print_dimacs() const;
   void print_clauses() const;
+  void clear();
   unsigned size() const;
+  bool splits_clauses() const { return do_split; }
 
 protected:
   VarHandler* vh;
@@ -29,23 +46,106 @@ protected:
   ClauseContainer(VarHandler*,unsigned split_size=0);
   const unsigned split_size;
   bool do_split = false;
+  int activation_lit = 0;
+
+  // Reused buffers, so adding a clause does not allocate once they have grown.
+  std::vector<int> guarded_clause;
+  std::vector<int> split_chunk;
+
+  // lits has room for one more literal after size.
+  void add_fixed_clause(int *lits, unsigned size)
+  {
+    if (activation_lit != 0)
+      lits[size++] = -1 * activation_lit;
+    if (do_split && size > split_size)
+      split_and_add_clause(lits, size);
+    else
+      do_add_clause(lits, size);
+  }
+  void split_and_add_clause(const int *lits, unsigned size);
 
 private:
-    virtual void do_add_clause(const Clause& c) = 0;
+    virtual void do_add_clause(const int *lits, unsigned size) = 0;
     virtual unsigned do_size() const = 0;
     virtual void do_print_dimacs() const = 0;
     virtual void do_clear() = 0;
     virtual void do_print_clauses() const = 0;
 };
 
+/*
+ * Base of the concrete clause containers. Its add_clause overloads hide
+ * those of ClauseContainer and call Sink::do_add_clause directly, so code
+ * holding a Sink pointer (see the encoders' Sink parameter) adds clauses
+ * without virtual calls. Sink has to befriend ClauseSink<Sink>.
+ */
+template <class Sink>
+class ClauseSink : public ClauseContainer {
+public:
+  void add_clause(const Clause& c) { add_clause(c.data(), c.size()); }
+  void add_clause(int a) { int lits[2] = {a}; add_sink_clause(lits, 1); }
+  void add_clause(int a, int b) { int lits[3] = {a, b}; add_sink_clause(lits, 2); }
+  void add_clause(int a, int b, int c) { int lits[4] = {a, b, c}; add_sink_clause(lits, 3); }
+  void add_clause(const int *lits, unsigned size)
+  {
+    if (activation_lit != 0 || do_split)
+      ClauseContainer::add_clause(lits, size);
+    else
+      static_cast<Sink *>(this)->Sink::do_add_clause(lits, size);
+  }
+
+protected:
+  ClauseSink(VarHandler *v, unsigned split_size) : ClauseContainer(v, split_size) {}
+
+private:
+  // Same as add_fixed_clause.
+  void add_sink_clause(int *lits, unsigned size)
+  {
+    if (activation_lit != 0)
+      lits[size++] = -1 * activation_lit;
+    if (do_split && size > split_size)
+      split_and_add_clause(lits, size);
+    else
+      static_cast<Sink *>(this)->Sink::do_add_clause(lits, size);
+  }
+};
+
 
-class ClauseVector : public ClauseContainer {
+/*
+ * Keeps all clauses in one literal buffer, clause i being
+ * literals[clause_starts[i]] up to literals[clause_starts[i + 1]].
+ */
+class ClauseVector final : public ClauseSink<ClauseVector> {
 public:
   ClauseVector(VarHandler*,int split_size);
   virtual ~ClauseVector();
 
+  class const_iterator {
+  public:
+    const_iterator(const ClauseVector *container, unsigned index) : cv(container), i(index) {}
+    ClauseView operator*() const { return cv->clause(i); }
+    const_iterator &operator++() { ++i; return *this; }
+    bool operator!=(const const_iterator &other) const { return i != other.i; }
+
+  private:
+    const ClauseVector *cv;
+    unsigned i;
+  };
+
+  ClauseView clause(unsigned i) const;
+  const_iterator begin() const;
+  const_iterator end() const;
+
 private:
-  void do_add_clause(const Clause& c) final;
+  friend class ClauseSink<ClauseVector>;
+
+  std::vector<int> literals;
+  std::vector<unsigned> clause_starts = {0};
+
+  void do_add_clause(const int *lits, unsigned size) final
+  {
+    literals.insert(literals.end(), lits, lits + size);
+    clause_starts.push_back(literals.size());
+  }
   unsigned do_size() const final;
   void do_print_dimacs() const final;
   void do_clear() final;
@@ -0,0 +1,118 @@
+#include "clause_transfer.h"
+
+#include <algorithm>
+#include <stdlib.h> //abs
+
+namespace SATABP
+{
+
+    ClauseTransfer::ClauseTransfer(int label_vars, unsigned max_size) : label_vars(label_vars), max_size(max_size) {};
+
+    unsigned ClauseTransfer::inject(CaDiCaL::Solver *s, int w)
+    {
+        unsigned injected = 0;
+        for (const std::pair<int, std::vector<int>> &entry : pool)
+        {
+            if (entry.first > w)
+                continue;
+            for (int lit : entry.second)
+                s->add(lit);
+            s->add(0);
+            injected++;
+        }
+        injected_count += injected;
+        return injected;
+    };
+
+    void ClauseTransfer::mark_originals(CaDiCaL::Solver *s)
+    {
+        originals.clear();
+        marking = true;
+        for (int var = 1; var <= label_vars; ++var)
+        {
+            int value = s->fixed(var);
+            if (value != 0)
+                originals.insert(clause_hash({value * var}));
+        }
+        s->traverse_clauses(*this);
+        marking = false;
+    };
+
+    unsigned ClauseTransfer::harvest(CaDiCaL::Solver *s, int w)
+    {
+        unsigned pool_before = pool.size();
+        harvest_width = w;
+        for (int var = 1; var <= label_vars; ++var)
+        {
+            int value = s->fixed(var);
+            if (value != 0)
+                consider({value * var});
+        }
+        s->traverse_clauses(*this);
+        originals.clear();
+
+        unsigned harvested = pool.size() - pool_before;
+        harvested_count += harvested;
+        return harvested;
+    };
+
+    bool ClauseTransfer::clause(const std::vector<int> &c)
+    {
+        if (!is_candidate(c))
+            return true;
+        if (marking)
+            originals.insert(clause_hash(c));
+        else
+            consider(c);
+        return true;
+    };
+
+    // A hash collision can only make a clause look old, never add a wrong one.
+    void ClauseTransfer::consider(const std::vector<int> &c)
+    {
+        uint64_t hash = clause_hash(c);
+        if (originals.count(hash) || !pooled.insert(hash).second)
+            return;
+        pool.emplace_back(harvest_width, c);
+    };
+
+    bool ClauseTransfer::is_candidate(const std::vector<int> &c) const
+    {
+        if (c.empty() || c.size() > max_size)
+            return false;
+        for (int lit : c)
+        {
+            if (std::abs(lit) > label_vars)
+                return false;
+        }
+        return true;
+    };
+
+    uint64_t ClauseTransfer::clause_hash(std::vector<int> c)
+    {
+        std::sort(c.begin(), c.end());
+        uint64_t hash = 14695981039346656037ULL;
+        for (int lit : c)
+        {
+            hash ^= (uint64_t)(uint32_t)lit;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    };
+
+    unsigned ClauseTransfer::pool_size() const
+    {
+        return pool.size();
+    };
+
+    unsigned long ClauseTransfer::total_harvested() const
+    {
+        return harvested_count;
+    };
+
+    unsigned long ClauseTransfer::total_injected() const
+    {
+        return injected_count;
+    };
+
+}
@@ -0,0 +1,63 @@
+#ifndef CLAUSE_TRANSFER_H
+#define CLAUSE_TRANSFER_H
+
+#include <stdint.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cadical.hpp"
+
+namespace SATABP
+{
+
+  /*
+   * Carries clauses over the label variables 1..n^2 from the solver of one
+   * width to the solvers of larger widths. Every labelling of width w + 1
+   * is also one of width w, so a clause implied at width w stays valid at
+   * any larger width, but not at a smaller one.
+   *
+   * CaDiCaL only exposes root-level units (fixed) and the irredundant
+   * clauses (traverse_clauses), so the harvest is the set of label-only
+   * units and clauses that were not in the formula before solving: learned
+   * units and clauses strengthened or produced by inprocessing.
+   */
+  class ClauseTransfer : public CaDiCaL::ClauseIterator
+  {
+  public:
+    ClauseTransfer(int label_vars, unsigned max_size);
+
+    // Adds the pooled clauses of widths <= w to s, returns their number.
+    unsigned inject(CaDiCaL::Solver *s, int w);
+    // Records the formula of s, call it right before solving.
+    void mark_originals(CaDiCaL::Solver *s);
+    // Moves the new label-only clauses of s into the pool, returns their number.
+    unsigned harvest(CaDiCaL::Solver *s, int w);
+
+    bool clause(const std::vector<int> &c) override;
+
+    unsigned pool_size() const;
+    unsigned long total_harvested() const;
+    unsigned long total_injected() const;
+
+  private:
+    int label_vars;
+    unsigned max_size;
+
+    bool marking = false;
+    int harvest_width = 0;
+    std::unordered_set<uint64_t> originals;
+    std::unordered_set<uint64_t> pooled;
+    std::vector<std::pair<int, std::vector<int>>> pool; // (source width, clause)
+
+    unsigned long harvested_count = 0;
+    unsigned long injected_count = 0;
+
+    bool is_candidate(const std::vector<int> &c) const;
+    static uint64_t clause_hash(std::vector<int> c);
+    void consider(const std::vector<int> &c);
+  };
+
+}
+
+#endif
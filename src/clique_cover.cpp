@@ -0,0 +1,126 @@
+#include "clique_cover.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace SATABP
+{
+
+    CliqueCover::CliqueCover(unsigned n, const std::vector<std::pair<int, int>> &edges)
+    {
+        neighbours = std::vector<std::vector<int>>(n);
+        for (std::pair<int, int> edge : edges)
+        {
+            int u = std::min(edge.first, edge.second) - 1;
+            int v = std::max(edge.first, edge.second) - 1;
+            if (u == v)
+                continue;
+            edge_list.push_back({u, v});
+            neighbours[u].push_back(v);
+            neighbours[v].push_back(u);
+        }
+        std::sort(edge_list.begin(), edge_list.end());
+        edge_list.erase(std::unique(edge_list.begin(), edge_list.end()), edge_list.end());
+        for (std::vector<int> &node_neighbours : neighbours)
+        {
+            std::sort(node_neighbours.begin(), node_neighbours.end());
+            node_neighbours.erase(std::unique(node_neighbours.begin(), node_neighbours.end()), node_neighbours.end());
+        }
+    };
+
+    void CliqueCover::run()
+    {
+        clique_list.clear();
+        std::vector<std::vector<bool>> covered(neighbours.size());
+        for (unsigned node = 0; node < neighbours.size(); ++node)
+        {
+            covered[node] = std::vector<bool>(neighbours[node].size(), false);
+        }
+
+        for (std::pair<int, int> edge : edge_list)
+        {
+            if (is_covered(edge.first, edge.second, covered))
+                continue;
+
+            std::vector<int> clique = grow_clique(edge.first, edge.second, covered);
+            for (unsigned i = 0; i < clique.size(); ++i)
+            {
+                for (unsigned j = i + 1; j < clique.size(); ++j)
+                {
+                    mark_covered(clique[i], clique[j], covered);
+                }
+            }
+            std::sort(clique.begin(), clique.end());
+            for (int &node : clique)
+            {
+                node++;
+            }
+            clique_list.push_back(clique);
+        }
+    };
+
+    const std::vector<std::vector<int>> &CliqueCover::cliques() const
+    {
+        return clique_list;
+    };
+
+    unsigned CliqueCover::edge_count() const
+    {
+        return edge_list.size();
+    };
+
+    bool CliqueCover::adjacent(int u, int v) const
+    {
+        return std::binary_search(neighbours[u].begin(), neighbours[u].end(), v);
+    };
+
+    /*
+     * Adds common neighbours of the clique while one still covers a new
+     * edge, taking the one that covers the most.
+     */
+    std::vector<int> CliqueCover::grow_clique(int u, int v, const std::vector<std::vector<bool>> &covered) const
+    {
+        std::vector<int> clique{u, v};
+        std::vector<int> candidates;
+        std::set_intersection(neighbours[u].begin(), neighbours[u].end(), neighbours[v].begin(), neighbours[v].end(),
+                              std::back_inserter(candidates));
+        while (!candidates.empty())
+        {
+            int best = -1;
+            unsigned best_new_edges = 0;
+            for (int candidate : candidates)
+            {
+                unsigned new_edges = std::count_if(clique.begin(), clique.end(), [this, &covered, candidate](int member)
+                                                   { return !is_covered(candidate, member, covered); });
+                if (new_edges > best_new_edges)
+                {
+                    best = candidate;
+                    best_new_edges = new_edges;
+                }
+            }
+            if (best < 0)
+                break;
+
+            clique.push_back(best);
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this, best](int candidate)
+                                            { return candidate == best || !adjacent(best, candidate); }),
+                             candidates.end());
+        }
+        return clique;
+    };
+
+    bool CliqueCover::is_covered(int u, int v, const std::vector<std::vector<bool>> &covered) const
+    {
+        auto position = std::lower_bound(neighbours[u].begin(), neighbours[u].end(), v);
+        return covered[u][position - neighbours[u].begin()];
+    };
+
+    void CliqueCover::mark_covered(int u, int v, std::vector<std::vector<bool>> &covered) const
+    {
+        auto position = std::lower_bound(neighbours[u].begin(), neighbours[u].end(), v);
+        covered[u][position - neighbours[u].begin()] = true;
+        position = std::lower_bound(neighbours[v].begin(), neighbours[v].end(), u);
+        covered[v][position - neighbours[v].begin()] = true;
+    };
+
+}
@@ -0,0 +1,41 @@
+#ifndef CLIQUE_COVER_H
+#define CLIQUE_COVER_H
+
+#include <utility>
+#include <vector>
+
+namespace SATABP
+{
+
+  /*
+   * Greedy cover of the edges by cliques. Any window of w consecutive
+   * labels holds at most one node of a clique, so the window AMOs of its
+   * edges can be replaced by one AMO over the window of all its nodes.
+   * Edges that are in no larger clique stay cliques of size 2.
+   */
+  class CliqueCover
+  {
+  public:
+    // Nodes 1..n, edges 1-based.
+    CliqueCover(unsigned n, const std::vector<std::pair<int, int>> &edges);
+
+    void run();
+
+    // Sorted 1-based nodes, every edge without a self loop is in at least one clique.
+    const std::vector<std::vector<int>> &cliques() const;
+    unsigned edge_count() const;
+
+  private:
+    std::vector<std::pair<int, int>> edge_list; // 0-based, smaller node first, no duplicates
+    std::vector<std::vector<int>> neighbours;   // sorted
+    std::vector<std::vector<int>> clique_list;
+
+    bool adjacent(int u, int v) const;
+    std::vector<int> grow_clique(int u, int v, const std::vector<std::vector<bool>> &covered) const;
+    bool is_covered(int u, int v, const std::vector<std::vector<bool>> &covered) const;
+    void mark_covered(int u, int v, std::vector<std::vector<bool>> &covered) const;
+  };
+
+}
+
+#endif
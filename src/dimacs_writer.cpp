@@ -0,0 +1,127 @@
+#include "dimacs_writer.h"
+
+#include <iostream>
+#include <fcntl.h>
+
+namespace SATABP
+{
+
+    namespace
+    {
+        const size_t buffer_size = 1 << 20;
+    }
+
+    DimacsWriter::DimacsWriter(VarHandler *v, int split_size, const std::string &file_name, bool count_only)
+        : ClauseSink(v, split_size), count_only(count_only)
+    {
+        if (count_only)
+            return;
+
+        if (file_name.empty())
+        {
+            out = stdout;
+            // A redirected stdout can be patched, a pipe or an appending redirection cannot.
+            std::cout << std::flush;
+            fflush(stdout);
+            int flags = fcntl(fileno(stdout), F_GETFL);
+            patchable = ftell(stdout) >= 0 && flags != -1 && !(flags & O_APPEND);
+        }
+        else
+        {
+            out = fopen(file_name.c_str(), "w");
+            own_file = true;
+            patchable = true;
+        }
+        if (out)
+            buffer.resize(buffer_size);
+    };
+
+    DimacsWriter::~DimacsWriter()
+    {
+        if (own_file && out)
+            fclose(out);
+    };
+
+    bool DimacsWriter::is_open() const
+    {
+        return count_only || out;
+    };
+
+    bool DimacsWriter::can_patch_header() const
+    {
+        return count_only || patchable;
+    };
+
+    void DimacsWriter::begin(int vars, unsigned clauses)
+    {
+        header_vars = vars;
+        header_clauses = clauses;
+        if (!out)
+            return;
+
+        std::cout << std::flush;
+        fflush(out);
+        header_pos = ftell(out);
+        write_header(vars, clauses);
+    };
+
+    void DimacsWriter::finish()
+    {
+        if (!out)
+            return;
+
+        flush_buffer();
+        int vars = vh->size();
+        if (vars == header_vars && clause_counter == header_clauses)
+        {
+            fflush(out);
+            return;
+        }
+
+        if (patchable && header_pos >= 0 && fseek(out, header_pos, SEEK_SET) == 0)
+        {
+            write_header(vars, clause_counter);
+            fseek(out, 0, SEEK_END);
+            fflush(out);
+        }
+        else
+        {
+            fflush(out);
+            std::cerr << "Error, the DIMACS header could not be patched to p cnf " << vars << " " << clause_counter << "." << std::endl;
+        }
+    };
+
+    void DimacsWriter::write_header(int vars, unsigned clauses)
+    {
+        // Padded with trailing spaces to a fixed width, so the final counts fit
+        // in place of the placeholder. Solvers reject extra spaces before the counts.
+        fprintf(out, "%-27s\n", ("p cnf " + std::to_string(vars) + " " + std::to_string(clauses)).c_str());
+    };
+
+    void DimacsWriter::flush_buffer()
+    {
+        fwrite(buffer.data(), 1, buffer_pos, out);
+        buffer_pos = 0;
+    };
+
+    unsigned DimacsWriter::do_size() const
+    {
+        return clause_counter;
+    };
+
+    void DimacsWriter::do_print_dimacs() const
+    {
+        std::cout << "c Print formula as dimacs: Not supported function with the streaming DIMACS writer, the clauses are already written.";
+    };
+
+    void DimacsWriter::do_print_clauses() const
+    {
+        std::cout << "c Print clauses: Not supported function with the streaming DIMACS writer, the clauses are already written.";
+    };
+
+    void DimacsWriter::do_clear()
+    {
+        std::cout << "c Clear clause-set: Not supported function with the streaming DIMACS writer.";
+    };
+
+}
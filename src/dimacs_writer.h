@@ -0,0 +1,99 @@
+#ifndef DIMACS_WRITER_H
+#define DIMACS_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "clause_cont.h"
+
+namespace SATABP {
+
+/*
+ * Streams clauses as DIMACS into a large buffer that is written out
+ * whenever it fills up, without keeping the formula. The header is
+ * written first with fixed-width counts and patched in finish() once
+ * the counts are known. If the output cannot be patched (a pipe or
+ * a file opened for appending), the counts have to be passed to
+ * begin(), e.g. from a counting-only pass.
+ */
+class DimacsWriter final : public ClauseSink<DimacsWriter> {
+public:
+  // Writes to stdout if file_name is empty. Counts only, without output, if count_only.
+  DimacsWriter(VarHandler*, int split_size, const std::string &file_name, bool count_only = false);
+  virtual ~DimacsWriter();
+
+  bool is_open() const;
+  bool can_patch_header() const;
+  void begin(int vars = 0, unsigned clauses = 0);
+  // Writes out the buffer and the final header.
+  void finish();
+
+private:
+  friend class ClauseSink<DimacsWriter>;
+
+  // Longest literal and separator: "-2147483648 ".
+  static constexpr size_t max_literal_chars = 12;
+
+  FILE *out = nullptr;
+  bool own_file = false;
+  bool count_only;
+  bool patchable = false;
+  long header_pos = -1;
+  int header_vars = 0;
+  unsigned header_clauses = 0;
+  unsigned clause_counter = 0;
+
+  std::vector<char> buffer;
+  size_t buffer_pos = 0;
+
+  void flush_buffer();
+  void write_header(int vars, unsigned clauses);
+
+  void append_literal(int lit)
+  {
+    char digits[max_literal_chars];
+    int digit_count = 0;
+    unsigned value = lit < 0 ? 0u - (unsigned)lit : (unsigned)lit;
+    do
+    {
+      digits[digit_count++] = '0' + value % 10;
+      value /= 10;
+    } while (value);
+
+    if (lit < 0)
+      buffer[buffer_pos++] = '-';
+    while (digit_count)
+      buffer[buffer_pos++] = digits[--digit_count];
+    buffer[buffer_pos++] = ' ';
+  }
+
+  void do_add_clause(const int *lits, unsigned size) final
+  {
+    clause_counter += 1;
+    if (!out)
+      return;
+
+    if (buffer_pos + (size + 1) * max_literal_chars > buffer.size())
+    {
+      flush_buffer();
+      if ((size + 1) * max_literal_chars > buffer.size())
+        buffer.resize((size + 1) * max_literal_chars);
+    }
+    for (unsigned i = 0; i < size; ++i)
+    {
+      append_literal(lits[i]);
+    }
+    buffer[buffer_pos++] = '0';
+    buffer[buffer_pos++] = '\n';
+  }
+
+  unsigned do_size() const final;
+  void do_print_dimacs() const final;
+  void do_clear() final;
+  void do_print_clauses() const final;
+};
+
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "duplex_encoder.h"
+#include "cadical_clauses.h"
+#include "dimacs_writer.h"
 
 #include <iostream>
 #include <numeric>   //iota
@@ -8,67 +10,198 @@
 
 namespace SATABP
 {
-    DuplexEncoder::DuplexEncoder(Graph *g, ClauseContainer *cc, VarHandler *vh)
-        : Encoder(g, cc, vh)
+    template <class Sink>
+    DuplexEncoder<Sink>::DuplexEncoder(Graph *g, Sink *cc, VarHandler *vh)
+        : Encoder(g, cc, vh), sink(cc)
     {
         init_members();
     }
 
-    void DuplexEncoder::init_members()
+    template <class Sink>
+    template <class OwnerSink>
+    DuplexEncoder<Sink>::DuplexEncoder(const DuplexEncoder<OwnerSink> &owner, Sink *cc, VarHandler *vh, unsigned first_node, unsigned last_node)
+        : Encoder(owner.g, cc, vh), sink(cc),
+          bh((last_node - first_node) * owner.g->n, first_node * owner.g->n + 1),
+          amz_literals_per_node(owner.amz_literals_per_node),
+          glue_literals(&owner.amz_literals), glue_group_starts(&owner.amz_group_starts), glue_label_ranges(&owner.amz_label_ranges),
+          window_w(owner.window_w), number_of_windows(owner.number_of_windows), last_window_w(owner.last_window_w)
     {
-        fwd_amo_roots = std::unordered_map<int, std::vector<int>>();
-        bwd_amo_roots = std::unordered_map<int, std::vector<int>>();
-        fwd_amz_roots = std::unordered_map<int, std::vector<int>>();
-        bwd_amz_roots = std::unordered_map<int, std::vector<int>>();
+        domains = owner.domains;
+        init_members();
+    }
 
-        node_amz_literals = std::unordered_map<int, std::vector<std::vector<int>>>();
+    template <class Sink>
+    void DuplexEncoder<Sink>::init_members()
+    {
+        fwd_amo_roots = std::vector<std::vector<int>>(g->n);
+        bwd_amo_roots = std::vector<std::vector<int>>(g->n);
+        fwd_amz_roots = std::vector<std::vector<int>>(g->n);
+        bwd_amz_roots = std::vector<std::vector<int>>(g->n);
     };
 
-    DuplexEncoder::~DuplexEncoder() {}
+    template <class Sink>
+    DuplexEncoder<Sink>::~DuplexEncoder() {}
 
-    int DuplexEncoder::do_vars_size() const
+    template <class Sink>
+    int DuplexEncoder<Sink>::do_vars_size() const
     {
         return vh->size();
     };
 
-    void DuplexEncoder::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    template <class Sink>
+    void DuplexEncoder<Sink>::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
     {
         num_l_v_constraints = 0;
+        num_l_v_aux_vars = 0;
+
+        encode_symmetry_break_choice();
+
+        // Column constraints last, keeps the original variable numbering.
+        encode_staircases(w, node_pairs);
+        encode_column_eo();
+
+        print_stats();
+    };
+
+    template <class Sink>
+    void DuplexEncoder<Sink>::do_encode_labelling_part()
+    {
+        num_l_v_constraints = 0;
+        num_l_v_aux_vars = 0;
+
+        encode_symmetry_break_choice();
+        encode_column_eo();
+    };
+
+    template <class Sink>
+    void DuplexEncoder<Sink>::do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
+        encode_staircases(w, node_pairs);
+        print_stats();
+    };
+
+    template <class Sink>
+    void DuplexEncoder<Sink>::encode_staircases(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
         num_obj_k_constraints = 0;
         num_obj_k_glue_staircase_constraint = 0;
-        num_l_v_aux_vars = 0;
         num_obj_k_aux_vars = 0;
 
-        if (symmetry_break_point == std::string("f"))
+        // BDD nodes of a previous width belong to clauses that are no longer active.
+        bh = BDDHandler(g->n * g->n);
+
+        construct_window_bdds(w);
+        if (parallel_encoding() && g->n > 1)
         {
-            encode_symmetry_break();
+            encode_staircases_parallel(node_pairs);
         }
-        else if (symmetry_break_point == std::string("h"))
+        else
         {
-            encode_symmetry_break_on_maxnode();
+            for (unsigned i = 0; i < g->n; ++i)
+            {
+                construct_node_bdds(i);
+            }
+            glue_window_bdds();
+
+            GlueEdges glue = split_glue_edges(node_pairs);
+            for (std::pair<int, int> nodes : glue.plain)
+            {
+                // std::cout << "(" << nodes.first << ", " << nodes.second << ")" << std::endl;
+                glue_edge_windows(nodes.first - 1, nodes.second - 1);
+            }
+            for (unsigned k = 0; k < glue.aggregated_nodes.size(); ++k)
+            {
+                glue_aggregated_windows(glue.aggregated_nodes[k], glue.aggregated_neighbours[k]);
+            }
         }
-        else if (symmetry_break_point == std::string("l"))
+        amz_literals.clear();
+        amz_group_starts.clear();
+        amz_label_ranges.clear();
+    };
+
+    /*
+     * Every node takes the same number of BDD variables, node 0 is encoded
+     * first to count them. The workers keep the BDDs and roots of their own
+     * nodes, which the window gluing of the same nodes needs. Edge gluing
+     * reads the merged AMZ literals.
+     */
+    template <class Sink>
+    void DuplexEncoder<Sink>::encode_staircases_parallel(const std::vector<std::pair<int, int>> &node_pairs)
+    {
+        int first_node_var = vh->last_var() + 1;
+        construct_node_bdds(0);
+        int node_vars = vh->last_var() + 1 - first_node_var;
+
+        EncodingBlocks node_blocks = make_blocks(g->n - 1, node_vars);
+        std::vector<std::unique_ptr<DuplexEncoder<ClauseVector>>> workers;
+        for (std::unique_ptr<EncodingBlock> &block : node_blocks)
         {
-            encode_symmetry_break_on_minnode();
+            workers.emplace_back(new DuplexEncoder<ClauseVector>(*this, &block->clauses, &block->vars, block->first + 1, block->last + 1));
         }
-        else
+        run_blocks(node_blocks, [&workers](EncodingBlock &block, unsigned b)
+                   {
+                       for (unsigned i = block.first; i < block.last; ++i)
+                       {
+                           workers[b]->construct_node_bdds(i + 1);
+                       } });
+        append_blocks(node_blocks);
+
+        glue_node_windows(0);
+        for (std::unique_ptr<DuplexEncoder<ClauseVector>> &worker : workers)
+        {
+            worker->amz_literals_per_node = amz_literals_per_node;
+        }
+        run_blocks(node_blocks, [&workers](EncodingBlock &block, unsigned b)
+                   {
+                       for (unsigned i = block.first; i < block.last; ++i)
+                       {
+                           workers[b]->glue_node_windows(i + 1);
+                       } });
+        append_blocks(node_blocks);
+        for (std::unique_ptr<DuplexEncoder<ClauseVector>> &worker : workers)
         {
-            // No symmetry breaking
+            amz_literals.insert(amz_literals.end(), worker->amz_literals.begin(), worker->amz_literals.end());
+            add_obj_k_stats(*worker);
         }
-        std::cout << "c\tEncode symmetry breaking with option: " << symmetry_break_point << "." << std::endl;
 
-        construct_window_bdds(w);
-        glue_window_bdds();
+        GlueEdges glue = split_glue_edges(node_pairs);
+        EncodingBlocks edge_blocks = make_blocks(glue.plain.size(), 0);
+        workers.clear();
+        for (std::unique_ptr<EncodingBlock> &block : edge_blocks)
+        {
+            workers.emplace_back(new DuplexEncoder<ClauseVector>(*this, &block->clauses, &block->vars, 0, 0));
+        }
+        run_blocks(edge_blocks, [&workers, &glue](EncodingBlock &block, unsigned b)
+                   {
+                       for (unsigned e = block.first; e < block.last; ++e)
+                       {
+                           workers[b]->glue_edge_windows(glue.plain[e].first - 1, glue.plain[e].second - 1);
+                       } });
+        append_blocks(edge_blocks);
+        for (std::unique_ptr<DuplexEncoder<ClauseVector>> &worker : workers)
+        {
+            add_obj_k_stats(*worker);
+        }
 
-        for (std::pair<int, int> nodes : node_pairs)
+        // Takes new variables, so it stays serial.
+        for (unsigned k = 0; k < glue.aggregated_nodes.size(); ++k)
         {
-            // std::cout << "(" << nodes.first << ", " << nodes.second << ")" << std::endl;
-            glue_edge_windows(nodes.first - 1, nodes.second - 1);
+            glue_aggregated_windows(glue.aggregated_nodes[k], glue.aggregated_neighbours[k]);
         }
-        node_amz_literals.clear();
+    };
 
-        encode_column_eo();
+    template <class Sink>
+    void DuplexEncoder<Sink>::add_obj_k_stats(const DuplexEncoder<ClauseVector> &worker)
+    {
+        num_l_v_constraints += worker.num_l_v_constraints;
+        num_obj_k_aux_vars += worker.num_obj_k_aux_vars;
+        num_obj_k_constraints += worker.num_obj_k_constraints;
+        num_obj_k_glue_staircase_constraint += worker.num_obj_k_glue_staircase_constraint;
+    };
 
+    template <class Sink>
+    void DuplexEncoder<Sink>::print_stats() const
+    {
         std::cout << "c\tLabels and Vertices aux var: " << num_l_v_aux_vars << std::endl;
         std::cout << "c\tLabels and Vertices constraints:  " << num_l_v_constraints << std::endl;
         std::cout << "c\tObj k aux var: " << num_obj_k_aux_vars << std::endl;
@@ -76,7 +209,8 @@ namespace SATABP
         std::cout << "c\tObj k glue staircase constraints: " << num_obj_k_glue_staircase_constraint << std::endl;
     };
 
-    void DuplexEncoder::seq_encode_column_eo()
+    template <class Sink>
+    void DuplexEncoder<Sink>::seq_encode_column_eo()
     {
         for (unsigned i = 0; i < g->n; i++)
         {
@@ -95,26 +229,27 @@ namespace SATABP
                 int curr = *i_pos;
                 int next = vh->get_new_var();
                 num_l_v_aux_vars++;
-                cv->add_clause({-1 * prev, -1 * curr});
+                sink->add_clause(-1 * prev, -1 * curr);
                 num_l_v_constraints++;
-                cv->add_clause({-1 * prev, next});
+                sink->add_clause(-1 * prev, next);
                 num_l_v_constraints++;
-                cv->add_clause({-1 * curr, next});
+                sink->add_clause(-1 * curr, next);
                 num_l_v_constraints++;
 
                 or_clause.push_back(curr);
                 prev = next;
             }
-            cv->add_clause({-1 * prev, -1 * (*std::prev(it_end))});
+            sink->add_clause(-1 * prev, -1 * (*std::prev(it_end)));
             num_l_v_constraints++;
 
             or_clause.push_back(*std::prev(it_end));
-            cv->add_clause(or_clause);
+            sink->add_clause(or_clause);
             num_l_v_constraints++;
         }
     };
 
-    void DuplexEncoder::encode_column_eo()
+    template <class Sink>
+    void DuplexEncoder<Sink>::encode_column_eo()
     {
         for (unsigned i = 0; i < g->n; i++)
         {
@@ -127,7 +262,8 @@ namespace SATABP
     };
 
     // Product then encode by seq
-    void DuplexEncoder::product_encode_eo(const std::vector<int> &vars)
+    template <class Sink>
+    void DuplexEncoder<Sink>::product_encode_eo(const std::vector<int> &vars)
     {
         if (vars.size() < 2)
             return;
@@ -136,9 +272,9 @@ namespace SATABP
         if (vars.size() == 2)
         {
             // simplifies to vars[0] /\ -1*vars[0], in case vars[0] == vars[1]
-            cv->add_clause({vars[0], vars[1]});
+            sink->add_clause(vars[0], vars[1]);
             num_l_v_constraints++;
-            cv->add_clause({-1 * vars[0], -1 * vars[1]});
+            sink->add_clause(-1 * vars[0], -1 * vars[1]);
             num_l_v_constraints++;
             return;
         }
@@ -167,15 +303,15 @@ namespace SATABP
             i = std::floor(idx / p);
             j = idx % p;
 
-            cv->add_clause({-1 * vars[idx], v_vars[i]});
+            sink->add_clause(-1 * vars[idx], v_vars[i]);
             num_l_v_constraints++;
-            cv->add_clause({-1 * vars[idx], u_vars[j]});
+            sink->add_clause(-1 * vars[idx], u_vars[j]);
             num_l_v_constraints++;
 
             // At least one
             or_clause.push_back(vars[idx]);
         }
-        cv->add_clause(or_clause);
+        sink->add_clause(or_clause);
         num_l_v_constraints++;
 
         // Similar results (faster on small instances, slightly worse on large)
@@ -186,7 +322,8 @@ namespace SATABP
         seq_encode_amo(v_vars);
     };
 
-    void DuplexEncoder::product_encode_amo(const std::vector<int> &vars)
+    template <class Sink>
+    void DuplexEncoder<Sink>::product_encode_amo(const std::vector<int> &vars)
     {
         if (vars.size() < 2)
             return;
@@ -194,7 +331,7 @@ namespace SATABP
         {
             if (vars[0] == vars[1])
                 return;
-            cv->add_clause({-1 * vars[0], -1 * vars[1]});
+            sink->add_clause(-1 * vars[0], -1 * vars[1]);
             num_l_v_constraints++;
             return;
         }
@@ -223,9 +360,9 @@ namespace SATABP
             i = std::floor(idx / p);
             j = idx % p;
 
-            cv->add_clause({-1 * vars[idx], v_vars[i]});
+            sink->add_clause(-1 * vars[idx], v_vars[i]);
             num_l_v_constraints++;
-            cv->add_clause({-1 * vars[idx], u_vars[j]});
+            sink->add_clause(-1 * vars[idx], u_vars[j]);
             num_l_v_constraints++;
         }
 
@@ -233,7 +370,8 @@ namespace SATABP
         product_encode_amo(v_vars);
     };
 
-    void DuplexEncoder::seq_encode_amo(const std::vector<int> &vars)
+    template <class Sink>
+    void DuplexEncoder<Sink>::seq_encode_amo(const std::vector<int> &vars)
     {
         if (vars.size() < 2)
             return;
@@ -245,223 +383,277 @@ namespace SATABP
             int curr = vars[idx];
             int next = vh->get_new_var();
             num_l_v_aux_vars++;
-            cv->add_clause({-1 * prev, -1 * curr});
+            sink->add_clause(-1 * prev, -1 * curr);
             num_l_v_constraints++;
-            cv->add_clause({-1 * prev, next});
+            sink->add_clause(-1 * prev, next);
             num_l_v_constraints++;
-            cv->add_clause({-1 * curr, next});
+            sink->add_clause(-1 * curr, next);
             num_l_v_constraints++;
 
             prev = next;
         }
-        cv->add_clause({-1 * prev, -1 * vars[vars.size() - 1]});
+        sink->add_clause(-1 * prev, -1 * vars[vars.size() - 1]);
         num_l_v_constraints++;
     };
 
-    void DuplexEncoder::construct_window_bdds(int w)
+    template <class Sink>
+    void DuplexEncoder<Sink>::construct_window_bdds(int w)
     {
+        window_w = w;
         number_of_windows = g->n / w;
         last_window_w = g->n % w;
         if (last_window_w != 0)
             number_of_windows++;
+        init_members();
+    };
 
-        for (unsigned i = 0; i < g->n; ++i)
+    template <class Sink>
+    void DuplexEncoder<Sink>::construct_node_bdds(unsigned i)
+    {
+        unsigned w = window_w;
+        for (unsigned gw = 0; gw < number_of_windows; ++gw)
         {
-            fwd_amo_roots[i] = std::vector<int>();
-            bwd_amo_roots[i] = std::vector<int>();
-            fwd_amz_roots[i] = std::vector<int>();
-            bwd_amz_roots[i] = std::vector<int>();
-
-            for (unsigned gw = 0; gw < number_of_windows; ++gw)
+            bool last_window = (gw == number_of_windows - 1);
+            int p1 = (i * g->n) + (gw * w) + 1;
+            int p2 = p1 + w - 1;
+            if (last_window)
+                p2 = (i + 1) * g->n;
+
+            int fwd_amo_id;
+            int fwd_amz_id;
+            if (gw != number_of_windows - 1)
             {
-                bool last_window = (gw == number_of_windows - 1);
-                int p1 = (i * g->n) + (gw * w) + 1;
-                int p2 = p1 + w - 1;
-                if (last_window)
-                    p2 = (i + 1) * g->n;
-
-                std::deque<unsigned int> window_vars(p2 - p1 + 1);
-                std::iota(window_vars.begin(), window_vars.end(), p1);
-
-                int fwd_amo_id;
-                int fwd_amz_id;
-                if (gw != number_of_windows - 1)
-                {
-                    fwd_amo_id = build_amo(window_vars);
-                    fwd_amz_id = build_amz(window_vars);
-                    fwd_amo_roots[i].push_back(fwd_amo_id);
-                    fwd_amz_roots[i].push_back(fwd_amz_id);
-                }
-
-                int bwd_amo_id;
-                int bwd_amz_id;
-                if (gw != 0)
-                {
-                    std::reverse(std::begin(window_vars), std::end(window_vars));
+                fwd_amo_id = build_amo(p1, p2);
+                fwd_amz_id = build_amz(p1, p2);
+                fwd_amo_roots[i].push_back(fwd_amo_id);
+                fwd_amz_roots[i].push_back(fwd_amz_id);
+            }
 
-                    bwd_amo_id = build_amo(window_vars);
-                    bwd_amz_id = build_amz(window_vars);
+            int bwd_amo_id;
+            int bwd_amz_id;
+            if (gw != 0)
+            {
+                bwd_amo_id = build_amo(p2, p1);
+                bwd_amz_id = build_amz(p2, p1);
 
-                    bwd_amo_roots[i].push_back(bwd_amo_id);
-                    bwd_amz_roots[i].push_back(bwd_amz_id);
-                }
+                bwd_amo_roots[i].push_back(bwd_amo_id);
+                bwd_amz_roots[i].push_back(bwd_amz_id);
+            }
 
-                if (gw == number_of_windows - 1)
-                {
-                    fwd_amo_roots[i].push_back(bwd_amo_id);
-                    fwd_amz_roots[i].push_back(bwd_amz_id);
-                }
-                else if (gw == 0)
-                {
-                    bwd_amo_roots[i].push_back(fwd_amo_id);
-                    bwd_amz_roots[i].push_back(fwd_amz_id);
-                }
-                else
-                {
-                    make_equal_bdds(fwd_amo_id, bwd_amo_id);
-                    make_equal_bdds(fwd_amz_id, bwd_amz_id);
-                }
+            if (gw == number_of_windows - 1)
+            {
+                fwd_amo_roots[i].push_back(bwd_amo_id);
+                fwd_amz_roots[i].push_back(bwd_amz_id);
+            }
+            else if (gw == 0)
+            {
+                bwd_amo_roots[i].push_back(fwd_amo_id);
+                bwd_amz_roots[i].push_back(fwd_amz_id);
+            }
+            else
+            {
+                make_equal_bdds(fwd_amo_id, bwd_amo_id);
+                make_equal_bdds(fwd_amz_id, bwd_amz_id);
+            }
 
-                if (window_vars.size() > 1)
-                {
-                    cv->add_clause({fwd_amo_id});
-                    num_obj_k_constraints++;
-                }
+            if (p2 > p1)
+            {
+                sink->add_clause(fwd_amo_id);
+                num_obj_k_constraints++;
             }
+        }
 
-            assert(!fwd_amz_roots[i].empty());
+        assert(!fwd_amz_roots[i].empty());
 
-            std::vector<int> amz_clause;
-            for (unsigned f = 0; f < fwd_amz_roots[i].size() - 1; ++f)
-            {
-                amz_clause.push_back(-1 * fwd_amz_roots[i][f]);
+        std::vector<int> amz_clause;
+        for (unsigned f = 0; f < fwd_amz_roots[i].size() - 1; ++f)
+        {
+            amz_clause.push_back(-1 * fwd_amz_roots[i][f]);
 
-                for (unsigned g = f + 1; g < fwd_amz_roots[i].size(); ++g)
-                {
-                    cv->add_clause({fwd_amz_roots[i][f], fwd_amz_roots[i][g]});
-                    num_l_v_constraints++;
-                }
-            }
-            amz_clause.push_back(-1 * fwd_amz_roots[i].back());
-            if (!amz_clause.empty())
+            for (unsigned g = f + 1; g < fwd_amz_roots[i].size(); ++g)
             {
-                cv->add_clause(amz_clause);
+                sink->add_clause(fwd_amz_roots[i][f], fwd_amz_roots[i][g]);
                 num_l_v_constraints++;
             }
         }
+        amz_clause.push_back(-1 * fwd_amz_roots[i].back());
+        if (!amz_clause.empty())
+        {
+            sink->add_clause(amz_clause);
+            num_l_v_constraints++;
+        }
     };
 
-    void DuplexEncoder::glue_window_bdds()
+    template <class Sink>
+    void DuplexEncoder<Sink>::glue_window_bdds()
     {
         for (unsigned var_group = 0; var_group < g->n; ++var_group)
         {
-            node_amz_literals[var_group] = std::vector<std::vector<int>>();
-            for (unsigned curr_window = 0; curr_window < number_of_windows - 1; ++curr_window)
-            {
-                node_amz_literals[var_group].push_back({fwd_amz_roots[var_group][curr_window]});
+            glue_node_windows(var_group);
+        }
+    };
 
-                int next_window = curr_window + 1;
+    template <class Sink>
+    void DuplexEncoder<Sink>::glue_node_windows(unsigned var_group)
+    {
+        // The groups are the same for every node, the first one records them.
+        unsigned node_start = amz_literals.size();
+        auto start_group = [this, var_group, node_start]()
+        {
+            if (var_group == 0)
+                amz_group_starts.push_back(amz_literals.size() - node_start);
+        };
+        // Node 0's variables are its labels.
+        auto record_range = [this, var_group](unsigned first, unsigned last)
+        {
+            if (var_group == 0)
+                amz_label_ranges.push_back({first, last});
+        };
 
-                int curr_fwd_amo = fwd_amo_roots[var_group][curr_window]; // bdd_amo_it
-                int next_bwd_amo = bwd_amo_roots[var_group][next_window];
+        for (unsigned curr_window = 0; curr_window < number_of_windows - 1; ++curr_window)
+        {
+            start_group();
+            amz_literals.push_back(fwd_amz_roots[var_group][curr_window]);
+            record_range(curr_window * window_w + 1, curr_window * window_w + window_w);
+
+            int next_window = curr_window + 1;
 
-                int fwd_from = bh.bdds[curr_fwd_amo].i_from;
-                int fwd_to = bh.bdds[curr_fwd_amo].i_to;
+            int curr_fwd_amo = fwd_amo_roots[var_group][curr_window]; // bdd_amo_it
+            int next_bwd_amo = bwd_amo_roots[var_group][next_window];
 
-                int bwd_from = bh.bdds[next_bwd_amo].i_from;
-                int bwd_to = bh.bdds[next_bwd_amo].i_to;
+            // The current window is never the last one, so it has full width.
+            int fwd_from = var_group * g->n + curr_window * window_w + 1;
+            int fwd_to = fwd_from + window_w - 1;
 
-                assert(bwd_to == fwd_to + 1);
+            int bwd_from = std::min(fwd_to + window_w, (var_group + 1) * g->n);
+            int bwd_to = fwd_to + 1;
 
-                if (fwd_from != fwd_to)
+            if (fwd_from != fwd_to)
+            {
+                sink->add_clause(curr_fwd_amo);
+                num_obj_k_constraints++;
+            }
+            if (bwd_from != bwd_to)
+            {
+                sink->add_clause(next_bwd_amo);
+                num_obj_k_constraints++;
+            }
+
+            // The full window was already saved as unit clause, so the
+            // forward part starts one after fwd_from.
+            for (int fwd_start = fwd_from + 1, bwd_start = bwd_to; fwd_start <= fwd_to && bwd_start <= bwd_from; ++fwd_start, ++bwd_start)
+            {
+                int b1_amo, b1_amz, b2_amo, b2_amz;
+
+                bh.lookup_amo(fwd_start, fwd_to, b1_amo);
+                assert(b1_amo != 0);
+                bh.lookup_amz(fwd_start, fwd_to, b1_amz);
+                assert(b1_amz != 0);
+                bh.lookup_amo(bwd_start, bwd_to, b2_amo);
+                assert(b2_amo != 0);
+                bh.lookup_amz(bwd_start, bwd_to, b2_amz);
+                assert(b2_amz != 0);
+
+                if (fwd_start < fwd_to)
                 {
-                    cv->add_clause({curr_fwd_amo});
+                    sink->add_clause(b1_amo);
                     num_obj_k_constraints++;
                 }
-                if (bwd_from != bwd_to)
+                if (bwd_start > bwd_to)
                 {
-                    cv->add_clause({next_bwd_amo});
+                    sink->add_clause(b2_amo);
                     num_obj_k_constraints++;
                 }
 
-                std::deque<int> fwd_window(fwd_to - fwd_from + 1);
-                std::iota(fwd_window.begin(), fwd_window.end(), fwd_from);
-                fwd_window.pop_front(); // the full window was already saved as unit clause
+                sink->add_clause(b1_amz, b2_amz);
+                num_obj_k_constraints++;
 
-                std::deque<int> bwd_window;
-                bwd_window.push_back(fwd_to + 1);
+                start_group();
+                amz_literals.push_back(b1_amz);
+                amz_literals.push_back(b2_amz);
+                record_range(fwd_start, fwd_to);
+                record_range(bwd_to, bwd_start);
+            }
+        }
+        start_group();
+        amz_literals.push_back(bwd_amz_roots[var_group][number_of_windows - 1]);
+        record_range((number_of_windows - 1) * window_w + 1, g->n);
 
-                std::pair<int, int> fwd_p, bwd_p;
+        if (var_group == 0)
+        {
+            amz_literals_per_node = amz_literals.size();
+            amz_group_starts.push_back(amz_literals_per_node);
+        }
+        assert(amz_literals.size() - node_start == amz_literals_per_node);
+    };
 
-                while (fwd_window.size() > 0 && bwd_window.back() <= bwd_from)
+    template <class Sink>
+    void DuplexEncoder<Sink>::glue_edge_windows(int node1, int node2)
+    {
+        const std::vector<unsigned> &group_starts = *glue_group_starts;
+        const int *node1_literals = glue_literals->data() + node1 * amz_literals_per_node;
+        const int *node2_literals = glue_literals->data() + node2 * amz_literals_per_node;
+        for (unsigned i = 0; i + 1 < group_starts.size(); ++i)
+        {
+            unsigned group_start = group_starts[i];
+            unsigned group_end = group_starts[i + 1];
+            for (unsigned c = group_start; c < group_end; ++c)
+            {
+                if (amz_literal_pruned(node1, c))
+                    continue;
+                for (unsigned d = group_start; d < group_end; ++d)
                 {
-
-                    fwd_p = std::pair<int, int>(fwd_window.front(), fwd_window.back());
-                    bwd_p = std::pair<int, int>(bwd_window.back(), bwd_window.front());
-
-                    int b1_amo, b1_amz, b2_amo, b2_amz;
-
-                    bh.lookup_amo(fwd_p, b1_amo);
-                    assert(b1_amo != 0);
-                    bh.lookup_amz(fwd_p, b1_amz);
-                    assert(b1_amz != 0);
-                    bh.lookup_amo(bwd_p, b2_amo);
-                    assert(b2_amo != 0);
-                    bh.lookup_amz(bwd_p, b2_amz);
-                    assert(b2_amz != 0);
-
-                    if (fwd_window.size() > 1)
-                    {
-                        cv->add_clause({b1_amo});
-                        num_obj_k_constraints++;
-                    }
-                    if (bwd_window.size() > 1)
-                    {
-                        cv->add_clause({b2_amo});
-                        num_obj_k_constraints++;
-                    }
-
-                    cv->add_clause({b1_amz, b2_amz});
+                    if (amz_literal_pruned(node2, d))
+                        continue;
+                    sink->add_clause(node1_literals[c], node2_literals[d]);
                     num_obj_k_constraints++;
-
-                    node_amz_literals[var_group].push_back({b1_amz, b2_amz});
-
-                    fwd_window.pop_front();
-                    bwd_window.push_back(bwd_window.back() + 1);
+                    num_obj_k_glue_staircase_constraint++;
                 }
             }
-            node_amz_literals[var_group].push_back({bwd_amz_roots[var_group][number_of_windows - 1]});
         }
     };
 
-    void DuplexEncoder::glue_edge_windows(int node1, int node2)
+    // An AMZ literal is false when its node occupies the windows of the literal.
+    template <class Sink>
+    void DuplexEncoder<Sink>::glue_aggregated_windows(int node, const std::vector<int> &neighbours)
     {
-        assert(node_amz_literals[node1].size() == node_amz_literals[node2].size());
-        for (unsigned i = 0; i < node_amz_literals[node1].size(); ++i)
+        const std::vector<unsigned> &group_starts = *glue_group_starts;
+        const int *node_literals = glue_literals->data() + node * amz_literals_per_node;
+        for (unsigned i = 0; i + 1 < group_starts.size(); ++i)
         {
-            std::vector<int> node1_amz_clause = node_amz_literals[node1][i];
-            std::vector<int> node2_amz_clause = node_amz_literals[node2][i];
-            assert(node1_amz_clause.size() == node2_amz_clause.size());
-            for (unsigned c = 0; c < node1_amz_clause.size(); ++c)
+            unsigned group_start = group_starts[i];
+            unsigned group_end = group_starts[i + 1];
+            int neighbour_in_window = vh->get_new_var();
+            num_obj_k_aux_vars++;
+
+            for (int neighbour : neighbours)
             {
-                for (unsigned d = 0; d < node2_amz_clause.size(); ++d)
+                const int *neighbour_literals = glue_literals->data() + neighbour * amz_literals_per_node;
+                for (unsigned d = group_start; d < group_end; ++d)
                 {
-                    cv->add_clause({node1_amz_clause[c], node2_amz_clause[d]});
+                    if (amz_literal_pruned(neighbour, d))
+                        continue;
+                    sink->add_clause(neighbour_literals[d], neighbour_in_window);
                     num_obj_k_constraints++;
                     num_obj_k_glue_staircase_constraint++;
                 }
             }
+            for (unsigned c = group_start; c < group_end; ++c)
+            {
+                if (amz_literal_pruned(node, c))
+                    continue;
+                sink->add_clause(node_literals[c], -1 * neighbour_in_window);
+                num_obj_k_constraints++;
+                num_obj_k_glue_staircase_constraint++;
+            }
         }
     };
 
-    BDD_id DuplexEncoder::build_amo(std::deque<unsigned int> vars)
+    template <class Sink>
+    BDD_id DuplexEncoder<Sink>::build_amo(int from, int to)
     {
         BDD_id lookup;
-        int from = vars.front();
-        int to = vars.back();
-        std::pair<int, int> from_to_pair(from, to);
-
-        if (bh.lookup_amo(from_to_pair, lookup))
+        if (bh.lookup_amo(from, to, lookup))
         {
             return lookup;
         }
@@ -469,7 +661,7 @@ namespace SATABP
         BDD new_bdd = BDD(from, to, 1);
         BDD_id true_child, false_child;
 
-        if (vars.size() == 1)
+        if (from == to)
         {
             new_bdd.id = from;
             true_child = 0;
@@ -479,15 +671,18 @@ namespace SATABP
         {
             new_bdd.id = vh->get_new_var();
             num_obj_k_aux_vars++;
-            vars.pop_front();
-            false_child = build_amo(vars);
-            true_child = build_amz(vars);
+            int next = from < to ? from + 1 : from - 1;
+            false_child = build_amo(next, to);
+            true_child = build_amz(next, to);
 
-            cv->add_clause({-1 * from, -1 * new_bdd.id, true_child});
-            num_obj_k_constraints++;
-            if (vars.size() > 1)
+            if (!label_var_pruned(from))
+            {
+                sink->add_clause(-1 * from, -1 * new_bdd.id, true_child);
+                num_obj_k_constraints++;
+            }
+            if (next != to)
             {
-                cv->add_clause({new_bdd.id * -1, false_child});
+                sink->add_clause(new_bdd.id * -1, false_child);
                 num_obj_k_constraints++;
             }
         }
@@ -499,14 +694,11 @@ namespace SATABP
         return new_bdd.id;
     };
 
-    BDD_id DuplexEncoder::build_amz(std::deque<unsigned int> vars)
+    template <class Sink>
+    BDD_id DuplexEncoder<Sink>::build_amz(int from, int to)
     {
         BDD_id lookup;
-        int from = vars.front();
-        int to = vars.back();
-        std::pair<int, int> from_to_pair(from, to);
-
-        if (bh.lookup_amz(from_to_pair, lookup))
+        if (bh.lookup_amz(from, to, lookup))
         {
             return lookup;
         }
@@ -514,7 +706,7 @@ namespace SATABP
         BDD new_bdd = BDD(from, to, 0);
         BDD_id true_child, false_child;
 
-        if (vars.size() == 1)
+        if (from == to)
         {
             new_bdd.id = -1 * from;
             true_child = 0;  //\bot BDD
@@ -525,14 +717,17 @@ namespace SATABP
             new_bdd.id = vh->get_new_var();
             num_obj_k_aux_vars++;
             true_child = 0; //\bot BDD
-            vars.pop_front();
-            false_child = build_amz(vars);
+            int next = from < to ? from + 1 : from - 1;
+            false_child = build_amz(next, to);
 
-            cv->add_clause({-1 * from, -1 * new_bdd.id});
-            num_obj_k_constraints++;
-            cv->add_clause({from, -1 * new_bdd.id, false_child});
+            if (!label_var_pruned(from))
+            {
+                sink->add_clause(-1 * from, -1 * new_bdd.id);
+                num_obj_k_constraints++;
+            }
+            sink->add_clause(from, -1 * new_bdd.id, false_child);
             num_obj_k_constraints++;
-            cv->add_clause({from, new_bdd.id, -1 * false_child});
+            sink->add_clause(from, new_bdd.id, -1 * false_child);
             num_obj_k_constraints++;
         }
 
@@ -543,30 +738,42 @@ namespace SATABP
         return new_bdd.id;
     };
 
-    void DuplexEncoder::make_equal_bdds(BDD_id b1, BDD_id b2)
+    template <class Sink>
+    bool DuplexEncoder<Sink>::amz_literal_pruned(int node, unsigned literal) const
+    {
+        const std::pair<unsigned, unsigned> &labels = (*glue_label_ranges)[literal];
+        return window_pruned(node, labels.first, labels.second);
+    };
+
+    template <class Sink>
+    void DuplexEncoder<Sink>::make_equal_bdds(BDD_id b1, BDD_id b2)
     {
         if (b1 == b2)
             return;
         if (b1 == -1)
         {
-            cv->add_clause({b2});
+            sink->add_clause(b2);
             num_obj_k_constraints++;
             return;
         }
 
         if (b2 == -1)
         {
-            cv->add_clause({b1});
+            sink->add_clause(b1);
             num_obj_k_constraints++;
             return;
         }
 
         assert(b1 > 0 && b2 > 0);
 
-        cv->add_clause({-1 * b1, b2});
+        sink->add_clause(-1 * b1, b2);
         num_obj_k_constraints++;
-        cv->add_clause({b1, -1 * b2});
+        sink->add_clause(b1, -1 * b2);
         num_obj_k_constraints++;
     };
 
+    template class DuplexEncoder<ClauseContainer>;
+    template class DuplexEncoder<ClauseVector>;
+    template class DuplexEncoder<CadicalClauseContainer>;
+    template class DuplexEncoder<DimacsWriter>;
 }
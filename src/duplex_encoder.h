@@ -4,27 +4,47 @@
 #include "encoder.h"
 #include "bdd.h"
 
-#include <deque>
-#include <unordered_map>
+#include <vector>
 
 namespace SATABP
 {
 
+  // Sink is the type of the clause container, see LadderEncoder.
+  template <class Sink = ClauseContainer>
   class DuplexEncoder : public Encoder
   {
   public:
-    DuplexEncoder(Graph *g, ClauseContainer *cc, VarHandler *vh);
+    DuplexEncoder(Graph *g, Sink *cc, VarHandler *vh);
     virtual ~DuplexEncoder();
 
   private:
-    BDDHandler bh;
+    template <class>
+    friend class DuplexEncoder;
 
-    std::unordered_map<int, std::vector<int>> fwd_amo_roots;
-    std::unordered_map<int, std::vector<int>> bwd_amo_roots;
-    std::unordered_map<int, std::vector<int>> fwd_amz_roots;
-    std::unordered_map<int, std::vector<int>> bwd_amz_roots;
+    Sink *sink;
+    BDDHandler bh;
 
-    std::unordered_map<int, std::vector<std::vector<int>>> node_amz_literals;
+    // Window roots per node.
+    std::vector<std::vector<int>> fwd_amo_roots;
+    std::vector<std::vector<int>> bwd_amo_roots;
+    std::vector<std::vector<int>> fwd_amz_roots;
+    std::vector<std::vector<int>> bwd_amz_roots;
+
+    /*
+     * AMZ literals glued between the staircases of adjacent nodes, node by
+     * node. Every node has the same groups, group i being literals
+     * amz_group_starts[i] up to amz_group_starts[i + 1] of the node.
+     */
+    std::vector<int> amz_literals;
+    std::vector<unsigned> amz_group_starts;
+    unsigned amz_literals_per_node = 0;
+    // Labels first..last that the AMZ literals of a node stand for, the same for every node.
+    std::vector<std::pair<unsigned, unsigned>> amz_label_ranges;
+    // Read by the edge gluing: the vectors above, or those of the encoder a worker encodes for.
+    const std::vector<int> *glue_literals = &amz_literals;
+    const std::vector<unsigned> *glue_group_starts = &amz_group_starts;
+    const std::vector<std::pair<unsigned, unsigned>> *glue_label_ranges = &amz_label_ranges;
+    unsigned window_w;
     unsigned number_of_windows;
     unsigned last_window_w;
 
@@ -36,17 +56,34 @@ namespace SATABP
     int num_obj_k_aux_vars = 0;
     int num_obj_k_glue_staircase_constraint = 0;
 
+    // Worker of a parallel encoding for the nodes first_node..last_node-1.
+    template <class OwnerSink>
+    DuplexEncoder(const DuplexEncoder<OwnerSink> &owner, Sink *cc, VarHandler *vh, unsigned first_node, unsigned last_node);
+
     void init_members();
 
     void do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs) final;
+    void do_encode_labelling_part() final;
+    void do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs) final;
+    void print_stats() const;
+
+    void encode_staircases(unsigned w, const std::vector<std::pair<int, int>> &node_pairs);
 
     int do_vars_size() const final;
 
+    void encode_staircases_parallel(const std::vector<std::pair<int, int>> &node_pairs);
+    void add_obj_k_stats(const DuplexEncoder<ClauseVector> &worker);
+
     void construct_window_bdds(int w);
+    void construct_node_bdds(unsigned i);
     void glue_window_bdds();
+    void glue_node_windows(unsigned var_group);
 
     void glue_edge_windows(int node1, int node2);
+    void glue_aggregated_windows(int node, const std::vector<int> &neighbours);
     void make_equal_bdds(BDD_id b1, BDD_id b2);
+    // The node cannot occupy the labels of its AMZ literal, so the literal is true.
+    bool amz_literal_pruned(int node, unsigned literal) const;
     void encode_column_eo();
     void seq_encode_column_eo();
 
@@ -54,9 +91,9 @@ namespace SATABP
     void product_encode_amo(const std::vector<int> &vars);
     void seq_encode_amo(const std::vector<int> &vars);
 
-    // Not & on purpose!
-    BDD_id build_amo(std::deque<unsigned int> vars);
-    BDD_id build_amz(std::deque<unsigned int> vars);
+    // BDD over the variables from up or down to to. Clauses satisfied by a pruned from are skipped, the nodes are still made.
+    BDD_id build_amo(int from, int to);
+    BDD_id build_amz(int from, int to);
   };
 
 }
@@ -1,8 +1,11 @@
 #include "encoder.h"
+#include "clique_cover.h"
 
 #include <iostream>
 #include <assert.h>
 #include <limits>
+#include <thread>
+#include <algorithm>
 
 namespace SATABP {
 
@@ -16,13 +19,61 @@ void Encoder::encode_antibandwidth(unsigned w, const std::vector<std::pair<int,i
         std::cout << "c Non-valid value of w, nothing to encode." << std::endl;
         return;
     }
+    prune_label_domains(w);
 	do_encode_antibandwidth(w,node_pairs);
 };
 
+void Encoder::encode_labelling_part() {
+    do_encode_labelling_part();
+};
+
+void Encoder::encode_width_part(unsigned w, const std::vector<std::pair<int,int>>& node_pairs) {
+    if (w < 1 || w > g->n) {
+        std::cout << "c Non-valid value of w, nothing to encode." << std::endl;
+        return;
+    }
+    prune_label_domains(w);
+    do_encode_width_part(w,node_pairs);
+};
+
+// The units go with the width part, under its activation literal when solving incrementally.
+void Encoder::prune_label_domains(unsigned w) {
+    if (!prune_domains)
+        return;
+    if (!label_domains)
+        label_domains.reset(new LabelDomains(g));
+    label_domains->run(w, prune_rounds);
+    domains = label_domains.get();
+
+    for (unsigned node = 0; node < g->n; node++) {
+        for (unsigned label = 1; label <= g->n; label++) {
+            if (!domains->allowed(node, label))
+                cv->add_clause(-1 * int(node * g->n + label));
+        }
+    }
+    std::cout << "c\tDomain pruning: " << domains->removed_count() << " of " << g->n * g->n << " label variables fixed to false, "
+              << domains->degree_removed_count() << " by degree, " << domains->rounds_used() << " propagation rounds." << std::endl;
+    if (domains->is_infeasible())
+        std::cout << "c\tDomain pruning: a node or label has no place left, w = " << w << " is UNSAT." << std::endl;
+};
+
+void Encoder::encode_symmetry_break_choice() {
+    if (symmetry_break_point == std::string("f")) {
+        encode_symmetry_break();
+    } else if (symmetry_break_point == std::string("h")) {
+        encode_symmetry_break_on_maxnode();
+    } else if (symmetry_break_point == std::string("l")) {
+        encode_symmetry_break_on_minnode();
+    } else {
+        // No symmetry breaking
+    }
+    std::cout << "c\tEncode symmetry breaking with option: " << symmetry_break_point << "." << std::endl;
+};
+
 void Encoder::encode_symmetry_break() {
     // Negate the second half
     for(unsigned i = g->n; i > g->n-(g->n/2); i--) {
-        cv->add_clause({-1*int(i)}); //narrowing, but we already failed if it is a too high unsigned
+        cv->add_clause(-1*int(i)); //narrowing, but we already failed if it is a too high unsigned
     }
 
     // // Negate the first half
@@ -36,7 +87,7 @@ void Encoder::encode_symmetry_break_on_maxnode() {
     
     // Negate the second half
     for(unsigned i = max_node_id*g->n; i > (max_node_id*g->n)-(g->n/2); i--) {
-        cv->add_clause({-1*int(i)}); //narrowing, but we already failed if it is a too high unsigned
+        cv->add_clause(-1*int(i)); //narrowing, but we already failed if it is a too high unsigned
     }
 
     // // Negate the first half
@@ -51,7 +102,7 @@ void Encoder::encode_symmetry_break_on_minnode() {
 
     // Negate the second half
     for(unsigned i = max_node_id*g->n; i > (max_node_id*g->n)-(g->n/2); i--) {
-        cv->add_clause({-1*int(i)}); //narrowing, but we already failed if it is a too high unsigned
+        cv->add_clause(-1*int(i)); //narrowing, but we already failed if it is a too high unsigned
     }
 
     // // Negate the first half
@@ -60,6 +111,99 @@ void Encoder::encode_symmetry_break_on_minnode() {
     // }
 };
 
+bool Encoder::parallel_encoding() const {
+    // Split variables are numbered while the clauses are added, so splitting keeps the serial order.
+    return encode_threads > 1 && !cv->splits_clauses();
+};
+
+EncodingBlocks Encoder::make_blocks(unsigned count, int vars_per_item) {
+    EncodingBlocks blocks;
+    unsigned block_count = std::min(encode_threads, count);
+    int first_var = vh->get_new_vars(count * vars_per_item);
+    for (unsigned b = 0; b < block_count; ++b) {
+        unsigned first = (unsigned long long)count * b / block_count;
+        unsigned last = (unsigned long long)count * (b + 1) / block_count;
+        blocks.emplace_back(new EncodingBlock(first, last, first_var + first * vars_per_item, (last - first) * vars_per_item));
+    }
+    return blocks;
+};
+
+void Encoder::run_blocks(EncodingBlocks& blocks, const std::function<void(EncodingBlock&, unsigned)>& work) {
+    std::vector<std::thread> threads;
+    for (unsigned b = 0; b < blocks.size(); ++b) {
+        threads.emplace_back([&blocks, &work, b]() { work(*blocks[b], b); });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+};
+
+void Encoder::append_blocks(EncodingBlocks& blocks) {
+    for (std::unique_ptr<EncodingBlock>& block : blocks) {
+        assert(block->vars.size() == block->var_budget);
+        for (ClauseView c : block->clauses) {
+            cv->add_clause(c.begin(), c.size());
+        }
+        block->clauses.clear();
+    }
+};
+GlueEdges Encoder::split_glue_edges(const std::vector<std::pair<int, int>>& edges) const {
+    GlueEdges glue;
+    if (!aggregate_glue) {
+        glue.plain = edges;
+        return glue;
+    }
+
+    std::vector<unsigned> degree(g->n, 0);
+    for (const std::pair<int, int>& edge : edges) {
+        degree[edge.first - 1]++;
+        degree[edge.second - 1]++;
+    }
+    auto collector = [&degree](int a, int b) {
+        if (degree[a] != degree[b])
+            return degree[a] > degree[b] ? a : b;
+        return std::min(a, b);
+    };
+    std::vector<std::vector<int>> collected(g->n);
+    for (const std::pair<int, int>& edge : edges) {
+        int a = edge.first - 1;
+        int b = edge.second - 1;
+        if (a == b)
+            continue;
+        int node = collector(a, b);
+        collected[node].push_back(node == a ? b : a);
+    }
+
+    // One collected edge is cheaper glued directly.
+    for (const std::pair<int, int>& edge : edges) {
+        int a = edge.first - 1;
+        int b = edge.second - 1;
+        if (a == b || collected[collector(a, b)].size() < 2)
+            glue.plain.push_back(edge);
+    }
+    for (unsigned node = 0; node < g->n; ++node) {
+        if (collected[node].size() >= 2) {
+            glue.aggregated_nodes.push_back(node);
+            glue.aggregated_neighbours.push_back(collected[node]);
+        }
+    }
+    std::cout << "c\tAggregated glue: " << glue.aggregated_nodes.size() << " nodes for " << edges.size() - glue.plain.size() << " of " << edges.size() << " edges." << std::endl;
+    return glue;
+};
+const std::vector<std::vector<int>>& Encoder::edge_cliques(const std::vector<std::pair<int, int>>& edges) {
+    if (!clique_cover_done) {
+        CliqueCover cover(g->n, edges);
+        cover.run();
+        clique_cover_cliques = cover.cliques();
+        clique_cover_done = true;
+
+        unsigned larger_cliques = std::count_if(clique_cover_cliques.begin(), clique_cover_cliques.end(),
+                                                [](const std::vector<int>& clique) { return clique.size() > 2; });
+        std::cout << "c\tClique cover: " << clique_cover_cliques.size() << " cliques for " << cover.edge_count()
+                  << " edges, " << larger_cliques << " larger than an edge." << std::endl;
+    }
+    return clique_cover_cliques;
+};
 
 void Encoder::print_clauses() const {
     cv->print_clauses();
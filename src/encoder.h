@@ -4,8 +4,11 @@
 #include <vector>
 #include <deque>
 #include <utility> //pair
+#include <memory>
+#include <functional>
 
 #include "clause_cont.h"
+#include "label_domains.h"
 
 namespace SATABP
 {
@@ -13,6 +16,30 @@ namespace SATABP
   typedef std::vector<int>::iterator vec_int_it;
   typedef std::deque<int>::iterator deq_int_it;
 
+  // Items first..last-1 of a parallel encoding, with their own clause buffer and variables.
+  struct EncodingBlock
+  {
+    EncodingBlock(unsigned first_item, unsigned last_item, int first_var, int var_count)
+        : first(first_item), last(last_item), var_budget(var_count), vars(first_var, 0), clauses(&vars, 0) {}
+
+    unsigned first;
+    unsigned last;
+    int var_budget;
+    VarHandler vars;
+    ClauseVector clauses;
+  };
+  typedef std::vector<std::unique_ptr<EncodingBlock>> EncodingBlocks;
+
+  // Edges of the glue constraints, see Encoder::aggregate_glue.
+  struct GlueEdges
+  {
+    // Glued one by one, 1-based as given.
+    std::vector<std::pair<int, int>> plain;
+    // 0-based, every node is glued to all its listed neighbours at once.
+    std::vector<int> aggregated_nodes;
+    std::vector<std::vector<int>> aggregated_neighbours;
+  };
+
   class Encoder
   {
   public:
@@ -22,9 +49,33 @@ namespace SATABP
     Encoder &operator=(Encoder const &) = delete;
 
     std::string symmetry_break_point = "n";
+    // Threads for the per-node and per-edge parts, used by the Ladder and Duplex encoders.
+    unsigned encode_threads = 1;
+    /*
+     * Glue every node that collects at least two edges to all of them at
+     * once, used by the Ladder and Duplex encoders: per window one literal
+     * "some neighbour occupies the window" is implied by the neighbours'
+     * window literals and excludes the node's own. Every edge goes to its
+     * endpoint of higher degree.
+     */
+    bool aggregate_glue = false;
+    // Cover the edges with cliques and encode one window AMO per clique, used by the Seq and Product encoders.
+    bool clique_cover = false;
+    /*
+     * Fix the label variables that no labelling of the width can use to
+     * false before the width part, see LabelDomains. The width parts skip
+     * the clauses these units satisfy.
+     */
+    bool prune_domains = false;
+    unsigned prune_rounds = 10;
 
     void encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs);
 
+    // Incremental use: the width-independent labelling part is encoded once,
+    // the width-dependent staircase/glue part once per probed width.
+    void encode_labelling_part();
+    void encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs);
+
     void print_clauses() const;
     void print_dimacs() const;
     int size() const;
@@ -38,12 +89,50 @@ namespace SATABP
     Graph *g;
     VarHandler *vh;
 
+    void encode_symmetry_break_choice();
     void encode_symmetry_break();
     void encode_symmetry_break_on_maxnode();
     void encode_symmetry_break_on_minnode();
 
+    /*
+     * Parallel encoding: items that each take vars_per_item variables are
+     * split into contiguous blocks whose variables follow the current last
+     * variable in item order. Every block is encoded into its own buffer on
+     * its own thread, and the buffers are added to cv in block order, so the
+     * formula is the same as encoding the items one after another. Blocks
+     * can be run again for a later part that takes no new variables.
+     */
+    bool parallel_encoding() const;
+    EncodingBlocks make_blocks(unsigned count, int vars_per_item);
+    static void run_blocks(EncodingBlocks &blocks, const std::function<void(EncodingBlock &, unsigned)> &work);
+    void append_blocks(EncodingBlocks &blocks);
+
+    // Label domains of the current width if pruned, nullptr otherwise.
+    const LabelDomains *domains = nullptr;
+    // No allowed label of node (0-based) in first..last, always false without pruning.
+    bool window_pruned(int node, unsigned first, unsigned last) const
+    {
+      return domains && !domains->any_allowed(node, first, last);
+    }
+    bool label_var_pruned(int label_var) const
+    {
+      return domains && !domains->allowed((label_var - 1) / g->n, (label_var - 1) % g->n + 1);
+    }
+
+    GlueEdges split_glue_edges(const std::vector<std::pair<int, int>> &edges) const;
+    // Computed on first use, the edges are the same for every width.
+    const std::vector<std::vector<int>> &edge_cliques(const std::vector<std::pair<int, int>> &edges);
+
   private:
+    std::unique_ptr<LabelDomains> label_domains;
+    std::vector<std::vector<int>> clique_cover_cliques;
+    bool clique_cover_done = false;
+
+    void prune_label_domains(unsigned w);
+
     virtual void do_encode_antibandwidth(unsigned w, std::vector<std::pair<int, int>> const &node_pairs) = 0;
+    virtual void do_encode_labelling_part() = 0;
+    virtual void do_encode_width_part(unsigned w, std::vector<std::pair<int, int>> const &node_pairs) = 0;
     virtual int do_vars_size() const = 0;
   };
 
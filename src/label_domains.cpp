@@ -0,0 +1,266 @@
+#include "label_domains.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace SATABP
+{
+
+    LabelDomains::LabelDomains(const Graph *graph) : g(graph)
+    {
+        neighbours = std::vector<std::vector<int>>(g->n);
+        for (std::pair<int, int> edge : g->edges)
+        {
+            int u = edge.first - 1;
+            int v = edge.second - 1;
+            if (u == v)
+                continue;
+            neighbours[u].push_back(v);
+            neighbours[v].push_back(u);
+        }
+        for (std::vector<int> &node_neighbours : neighbours)
+        {
+            std::sort(node_neighbours.begin(), node_neighbours.end());
+            node_neighbours.erase(std::unique(node_neighbours.begin(), node_neighbours.end()), node_neighbours.end());
+        }
+    };
+
+    void LabelDomains::run(unsigned w, unsigned rounds)
+    {
+        unsigned n = g->n;
+        allowed_labels.assign(n * n, 1);
+        allowed_prefix.assign(n * (n + 1), 0);
+        removed = 0;
+        rounds_run = 0;
+        infeasible = false;
+
+        for (unsigned node = 0; node < n; ++node)
+        {
+            int degree = neighbours[node].size();
+            for (unsigned label = 1; label <= n; ++label)
+            {
+                int below = (int)label - (int)w;
+                int above = (int)n - (int)label - (int)w + 1;
+                if (std::max(below, 0) + std::max(above, 0) < degree)
+                    remove(node, label);
+            }
+            update_prefix(node);
+        }
+        degree_removed = removed;
+
+        while (!infeasible && rounds_run < rounds)
+        {
+            rounds_run++;
+            bool changed = propagate_neighbours(w);
+            changed = propagate_singles() || changed;
+            if (!changed)
+                break;
+        }
+    };
+
+    bool LabelDomains::allowed(unsigned node, unsigned label) const
+    {
+        assert(node < g->n && 1 <= label && label <= g->n);
+        return allowed_labels[node * g->n + label - 1];
+    };
+
+    bool LabelDomains::any_allowed(unsigned node, unsigned first, unsigned last) const
+    {
+        assert(node < g->n && 1 <= first && last <= g->n);
+        return allowed_between(node, first, last) > 0;
+    };
+
+    unsigned LabelDomains::removed_count() const
+    {
+        return removed;
+    };
+
+    unsigned LabelDomains::degree_removed_count() const
+    {
+        return degree_removed;
+    };
+
+    unsigned LabelDomains::rounds_used() const
+    {
+        return rounds_run;
+    };
+
+    bool LabelDomains::is_infeasible() const
+    {
+        return infeasible;
+    };
+
+    unsigned LabelDomains::allowed_between(unsigned node, unsigned first, unsigned last) const
+    {
+        if (first > last)
+            return 0;
+        const unsigned *prefix = allowed_prefix.data() + node * (g->n + 1);
+        return prefix[last] - prefix[first - 1];
+    };
+
+    // Allowed labels of node at distance at least w from label.
+    unsigned LabelDomains::far_allowed(unsigned node, unsigned label, unsigned w) const
+    {
+        unsigned count = 0;
+        if (label > w)
+            count += allowed_between(node, 1, label - w);
+        if (label + w <= g->n)
+            count += allowed_between(node, label + w, g->n);
+        return count;
+    };
+
+    void LabelDomains::remove(unsigned node, unsigned label)
+    {
+        char &label_allowed = allowed_labels[node * g->n + label - 1];
+        if (!label_allowed)
+            return;
+        label_allowed = 0;
+        removed++;
+    };
+
+    void LabelDomains::update_prefix(unsigned node)
+    {
+        unsigned n = g->n;
+        unsigned *prefix = allowed_prefix.data() + node * (n + 1);
+        const char *node_labels = allowed_labels.data() + node * n;
+        for (unsigned label = 1; label <= n; ++label)
+        {
+            prefix[label] = prefix[label - 1] + node_labels[label - 1];
+        }
+        if (prefix[n] == 0)
+            infeasible = true;
+    };
+
+    bool LabelDomains::propagate_neighbours(unsigned w)
+    {
+        unsigned n = g->n;
+        bool changed = false;
+        std::vector<char> neighbour_labels(n);
+        std::vector<unsigned> neighbour_prefix(n + 1, 0);
+        auto neighbour_labels_between = [&neighbour_prefix](unsigned first, unsigned last)
+        {
+            return first > last ? 0 : neighbour_prefix[last] - neighbour_prefix[first - 1];
+        };
+
+        for (unsigned node = 0; node < n; ++node)
+        {
+            const std::vector<int> &node_neighbours = neighbours[node];
+            if (node_neighbours.empty())
+                continue;
+
+            std::fill(neighbour_labels.begin(), neighbour_labels.end(), 0);
+            for (int neighbour : node_neighbours)
+            {
+                const char *labels = allowed_labels.data() + neighbour * n;
+                for (unsigned l = 0; l < n; ++l)
+                {
+                    neighbour_labels[l] |= labels[l];
+                }
+            }
+            for (unsigned label = 1; label <= n; ++label)
+            {
+                neighbour_prefix[label] = neighbour_prefix[label - 1] + neighbour_labels[label - 1];
+            }
+
+            bool node_changed = false;
+            for (unsigned label = 1; label <= n; ++label)
+            {
+                if (!allowed(node, label))
+                    continue;
+
+                unsigned far_labels = 0;
+                if (label > w)
+                    far_labels += neighbour_labels_between(1, label - w);
+                if (label + w <= n)
+                    far_labels += neighbour_labels_between(label + w, n);
+                bool supported = far_labels >= node_neighbours.size();
+                for (auto it = node_neighbours.begin(); supported && it != node_neighbours.end(); ++it)
+                {
+                    supported = far_allowed(*it, label, w) > 0;
+                }
+                if (!supported)
+                {
+                    remove(node, label);
+                    node_changed = true;
+                }
+            }
+            if (node_changed)
+            {
+                update_prefix(node);
+                changed = true;
+            }
+        }
+        return changed;
+    };
+
+    bool LabelDomains::propagate_singles()
+    {
+        unsigned n = g->n;
+        std::vector<char> touched(n, 0);
+
+        for (unsigned label = 1; label <= n; ++label)
+        {
+            unsigned holders = 0;
+            unsigned holder = 0;
+            for (unsigned node = 0; node < n && holders < 2; ++node)
+            {
+                if (allowed(node, label))
+                {
+                    holders++;
+                    holder = node;
+                }
+            }
+            if (holders == 0)
+            {
+                infeasible = true;
+                return false;
+            }
+            if (holders > 1 || allowed_between(holder, 1, n) == 1)
+                continue;
+            for (unsigned other = 1; other <= n; ++other)
+            {
+                if (other != label && allowed(holder, other))
+                {
+                    remove(holder, other);
+                    touched[holder] = 1;
+                }
+            }
+            update_prefix(holder);
+        }
+
+        for (unsigned node = 0; node < n; ++node)
+        {
+            if (allowed_between(node, 1, n) != 1)
+                continue;
+            // Removals of this loop are not in the prefix yet, the label may be gone.
+            unsigned label = 1;
+            while (label <= n && !allowed(node, label))
+                label++;
+            if (label > n)
+            {
+                infeasible = true;
+                return false;
+            }
+            for (unsigned other = 0; other < n; ++other)
+            {
+                if (other != node && allowed(other, label))
+                {
+                    remove(other, label);
+                    touched[other] = 1;
+                }
+            }
+        }
+
+        bool changed = false;
+        for (unsigned node = 0; node < n; ++node)
+        {
+            if (touched[node])
+            {
+                update_prefix(node);
+                changed = true;
+            }
+        }
+        return changed;
+    };
+
+}
@@ -0,0 +1,64 @@
+#ifndef LABEL_DOMAINS_H
+#define LABEL_DOMAINS_H
+
+#include <vector>
+
+#include "utils.h"
+
+namespace SATABP
+{
+
+  /*
+   * Labels every node can still take in a labelling of antibandwidth at
+   * least w. A node of degree d at label l needs d labels at distance at
+   * least w for its neighbours, and only (l - w) + (n - l - w + 1) exist,
+   * so high degree nodes lose the middle labels at large w. The rounds
+   * then propagate:
+   *  - every neighbour needs an allowed label at distance at least w;
+   *  - the neighbours need d distinct labels at distance at least w
+   *    among the labels allowed for any of them;
+   *  - a label allowed for only one node is that node's label, and the
+   *    label of a node with one allowed label is taken for all others.
+   * Only labels that no labelling of width w uses are removed.
+   */
+  class LabelDomains
+  {
+  public:
+    explicit LabelDomains(const Graph *graph);
+
+    // Domains for width w from scratch, at most rounds propagation rounds after the degree rule.
+    void run(unsigned w, unsigned rounds);
+
+    // node 0-based, labels 1-based.
+    bool allowed(unsigned node, unsigned label) const;
+    bool any_allowed(unsigned node, unsigned first, unsigned last) const;
+
+    unsigned removed_count() const;
+    unsigned degree_removed_count() const;
+    unsigned rounds_used() const;
+    // Some node or label is left without a place, w is UNSAT.
+    bool is_infeasible() const;
+
+  private:
+    const Graph *g;
+    std::vector<std::vector<int>> neighbours; // 0-based, sorted, no self loops or duplicates
+
+    std::vector<char> allowed_labels;       // node * n + label - 1
+    std::vector<unsigned> allowed_prefix;   // node * (n + 1) + l: allowed labels of node in 1..l
+    unsigned removed = 0;
+    unsigned degree_removed = 0;
+    unsigned rounds_run = 0;
+    bool infeasible = false;
+
+    unsigned allowed_between(unsigned node, unsigned first, unsigned last) const;
+    unsigned far_allowed(unsigned node, unsigned label, unsigned w) const;
+    void remove(unsigned node, unsigned label);
+    void update_prefix(unsigned node);
+
+    bool propagate_neighbours(unsigned w);
+    bool propagate_singles();
+  };
+
+}
+
+#endif
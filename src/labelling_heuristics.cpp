@@ -0,0 +1,297 @@
+#include "labelling_heuristics.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <assert.h>
+#include <stdlib.h> //abs
+
+namespace SATABP
+{
+
+    LabellingHeuristics::LabellingHeuristics(const Graph *graph) : g(graph)
+    {
+        build_adjacency();
+    };
+
+    void LabellingHeuristics::build_adjacency()
+    {
+        adj_offsets = std::vector<int>(g->n + 1, 0);
+        for (std::pair<int, int> edge : g->edges)
+        {
+            if (edge.first == edge.second)
+                continue;
+            adj_offsets[edge.first]++;
+            adj_offsets[edge.second]++;
+        }
+        for (unsigned i = 1; i <= g->n; ++i)
+        {
+            adj_offsets[i] += adj_offsets[i - 1];
+        }
+
+        adj_nodes = std::vector<int>(adj_offsets[g->n]);
+        std::vector<int> fill(adj_offsets.begin(), adj_offsets.end() - 1);
+        for (std::pair<int, int> edge : g->edges)
+        {
+            if (edge.first == edge.second)
+                continue;
+            adj_nodes[fill[edge.first - 1]++] = edge.second - 1;
+            adj_nodes[fill[edge.second - 1]++] = edge.first - 1;
+        }
+    };
+
+    int LabellingHeuristics::run()
+    {
+        if (g->n < 2)
+            return 0;
+
+        int u = find_peripheral_node(0);
+        int v = find_peripheral_node(u);
+
+        std::vector<int> labels;
+        for (int start : {u, v})
+        {
+            level_structure_labelling(start, labels);
+            evaluate(labels, "level structure from node " + std::to_string(start + 1));
+
+            std::vector<int> order, levels;
+            bfs_order(start, order, levels, true);
+            greedy_spreading_labelling(order, labels);
+            evaluate(labels, "greedy spreading in BFS order from node " + std::to_string(start + 1));
+        }
+
+        std::vector<int> degree_order(g->n);
+        for (unsigned i = 0; i < g->n; ++i)
+            degree_order[i] = i;
+        std::stable_sort(degree_order.begin(), degree_order.end(), [this](int a, int b)
+                         { return adj_offsets[a + 1] - adj_offsets[a] > adj_offsets[b + 1] - adj_offsets[b]; });
+        greedy_spreading_labelling(degree_order, labels);
+        evaluate(labels, "greedy spreading in decreasing degree order");
+
+        return best_abw;
+    };
+
+    /*
+     * BFS from start, levels[i] is the BFS level of node i. With
+     * all_components the BFS goes on in the remaining components, whose
+     * levels continue after the last level of the previous one.
+     */
+    void LabellingHeuristics::bfs_order(int start, std::vector<int> &order, std::vector<int> &levels, bool all_components) const
+    {
+        order.clear();
+        order.reserve(g->n);
+        levels = std::vector<int>(g->n, -1);
+
+        int next_level = 0;
+        unsigned next_root = 0;
+        int root = start;
+        while (true)
+        {
+            levels[root] = next_level;
+            unsigned head = order.size();
+            order.push_back(root);
+            while (head < order.size())
+            {
+                int node = order[head++];
+                for (int pos = adj_offsets[node]; pos < adj_offsets[node + 1]; ++pos)
+                {
+                    int nb = adj_nodes[pos];
+                    if (levels[nb] < 0)
+                    {
+                        levels[nb] = levels[node] + 1;
+                        order.push_back(nb);
+                    }
+                }
+            }
+            if (!all_components)
+                break;
+            next_level = levels[order.back()] + 1;
+
+            while (next_root < g->n && levels[next_root] >= 0)
+                next_root++;
+            if (next_root == g->n)
+                break;
+            root = next_root;
+        }
+    };
+
+    int LabellingHeuristics::find_peripheral_node(int start) const
+    {
+        std::vector<int> order, levels;
+        bfs_order(start, order, levels, false);
+
+        // The last node reached is one of the farthest from start.
+        return order.back();
+    };
+
+    /*
+     * Edges only join nodes of the same or of adjacent BFS levels. Labelling
+     * all even levels before all odd levels puts adjacent levels about n/2
+     * labels apart.
+     */
+    void LabellingHeuristics::level_structure_labelling(int start, std::vector<int> &labels) const
+    {
+        std::vector<int> order, levels;
+        bfs_order(start, order, levels, true);
+
+        labels = std::vector<int>(g->n, 0);
+        int next_label = 1;
+        for (int parity = 0; parity < 2; ++parity)
+        {
+            for (int node : order)
+            {
+                if (levels[node] % 2 == parity)
+                    labels[node] = next_label++;
+            }
+        }
+    };
+
+    /*
+     * Gives every node, in the given order, the free label farthest from the
+     * labels of its already labelled neighbours. Only the free labels nearest
+     * to the ends and to the middle of each gap between neighbour labels are
+     * tried, so a node costs O(deg log n).
+     */
+    void LabellingHeuristics::greedy_spreading_labelling(const std::vector<int> &order, std::vector<int> &labels) const
+    {
+        int n = g->n;
+        labels = std::vector<int>(n, 0);
+        std::set<int> free_labels;
+        for (int l = 1; l <= n; ++l)
+            free_labels.insert(free_labels.end(), l);
+
+        std::vector<int> nb_labels;
+        for (int node : order)
+        {
+            nb_labels.clear();
+            for (int pos = adj_offsets[node]; pos < adj_offsets[node + 1]; ++pos)
+            {
+                if (labels[adj_nodes[pos]] > 0)
+                    nb_labels.push_back(labels[adj_nodes[pos]]);
+            }
+
+            int chosen = *free_labels.begin();
+            if (!nb_labels.empty())
+            {
+                std::sort(nb_labels.begin(), nb_labels.end());
+
+                auto distance = [&nb_labels](int l)
+                {
+                    auto it = std::lower_bound(nb_labels.begin(), nb_labels.end(), l);
+                    int dist = std::abs(l - *std::prev(nb_labels.end()));
+                    if (it != nb_labels.end())
+                        dist = std::min(dist, *it - l);
+                    if (it != nb_labels.begin())
+                        dist = std::min(dist, l - *std::prev(it));
+                    return dist;
+                };
+
+                std::vector<int> targets{1, n};
+                for (unsigned i = 0; i + 1 < nb_labels.size(); ++i)
+                    targets.push_back((nb_labels[i] + nb_labels[i + 1]) / 2);
+
+                int best_dist = -1;
+                for (int target : targets)
+                {
+                    auto it = free_labels.lower_bound(target);
+                    if (it != free_labels.end() && distance(*it) > best_dist)
+                    {
+                        best_dist = distance(*it);
+                        chosen = *it;
+                    }
+                    if (it != free_labels.begin() && distance(*std::prev(it)) > best_dist)
+                    {
+                        best_dist = distance(*std::prev(it));
+                        chosen = *std::prev(it);
+                    }
+                }
+            }
+
+            labels[node] = chosen;
+            free_labels.erase(chosen);
+        }
+    };
+
+    void LabellingHeuristics::evaluate(const std::vector<int> &labels, const std::string &name)
+    {
+        assert(std::find(labels.begin(), labels.end(), 0) == labels.end());
+        int abw = g->calculate_antibandwidth(labels);
+        std::cout << "c\tHeuristic " << name << ": antibandwidth = " << abw << "." << std::endl;
+        if (abw > best_abw)
+        {
+            best_abw = abw;
+            best_labels = labels;
+            best_name = name;
+        }
+    };
+
+    int LabellingHeuristics::best_antibandwidth() const
+    {
+        return best_abw;
+    };
+
+    const std::vector<int> &LabellingHeuristics::best_labelling() const
+    {
+        return best_labels;
+    };
+
+    const std::string &LabellingHeuristics::best_variant() const
+    {
+        return best_name;
+    };
+
+    // One "<node> <label>" line per node, nodes numbered from 1 as in the graph file.
+    bool LabellingHeuristics::write_labelling(const std::string &file_name) const
+    {
+        std::ofstream out(file_name);
+        if (!out.is_open())
+        {
+            std::cout << "c Error, could not open file '" << file_name << "'. " << std::endl;
+            return false;
+        }
+        out << "c " << g->graph_name << " antibandwidth = " << best_abw << " (" << best_name << ")" << std::endl;
+        for (unsigned node = 0; node < best_labels.size(); ++node)
+        {
+            out << node + 1 << " " << best_labels[node] << std::endl;
+        }
+        return true;
+    };
+
+    bool LabellingHeuristics::read_labelling(const std::string &file_name, unsigned n, std::vector<int> &labels)
+    {
+        std::ifstream in(file_name);
+        if (!in.is_open())
+        {
+            std::cout << "c Error, could not open file '" << file_name << "'. " << std::endl;
+            return false;
+        }
+
+        labels = std::vector<int>(n, 0);
+        std::vector<bool> used(n + 1, false);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == 'c' || line[0] == '%')
+                continue;
+            std::istringstream iss(line);
+            int node, label;
+            if (!(iss >> node >> label) || node < 1 || node > (int)n || label < 1 || label > (int)n || labels[node - 1] != 0 || used[label])
+            {
+                std::cout << "c Error, invalid labelling line '" << line << "' in " << file_name << "." << std::endl;
+                return false;
+            }
+            labels[node - 1] = label;
+            used[label] = true;
+        }
+        if (std::find(labels.begin(), labels.end(), 0) != labels.end())
+        {
+            std::cout << "c Error, " << file_name << " does not label every node." << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+}
@@ -0,0 +1,56 @@
+#ifndef LABELLING_HEURISTICS_H
+#define LABELLING_HEURISTICS_H
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace SATABP
+{
+
+  /*
+   * Constructive labellings used to raise the LB before any SAT call.
+   * Labellings are stored like Graph::calculate_antibandwidth expects them:
+   * labels[node - 1] is the label (1..n) of node.
+   */
+  class LabellingHeuristics
+  {
+  public:
+    explicit LabellingHeuristics(const Graph *graph);
+
+    // Runs every variant, returns the best antibandwidth found.
+    int run();
+
+    int best_antibandwidth() const;
+    const std::vector<int> &best_labelling() const;
+    const std::string &best_variant() const;
+
+    bool write_labelling(const std::string &file_name) const;
+    // Reads a file in the format of write_labelling, labels must be a permutation of 1..n.
+    static bool read_labelling(const std::string &file_name, unsigned n, std::vector<int> &labels);
+
+  private:
+    const Graph *g;
+
+    // Adjacency in CSR form, self loops dropped.
+    std::vector<int> adj_offsets;
+    std::vector<int> adj_nodes;
+
+    int best_abw = 0;
+    std::vector<int> best_labels;
+    std::string best_name;
+
+    void build_adjacency();
+    void bfs_order(int start, std::vector<int> &order, std::vector<int> &levels, bool all_components) const;
+    int find_peripheral_node(int start) const;
+
+    void level_structure_labelling(int start, std::vector<int> &labels) const;
+    void greedy_spreading_labelling(const std::vector<int> &order, std::vector<int> &labels) const;
+
+    void evaluate(const std::vector<int> &labels, const std::string &name);
+  };
+
+}
+
+#endif
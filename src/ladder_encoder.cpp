@@ -1,5 +1,7 @@
 #include "ladder_encoder.h"
 #include "math_extension.h"
+#include "cadical_clauses.h"
+#include "dimacs_writer.h"
 
 #include <iostream>
 #include <numeric>
@@ -10,90 +12,121 @@
 
 namespace SATABP
 {
-    LadderEncoder::LadderEncoder(Graph *g, ClauseContainer *cc, VarHandler *vh) : Encoder(g, cc, vh)
+    template <class Sink>
+    LadderEncoder<Sink>::LadderEncoder(Graph *g, Sink *cc, VarHandler *vh) : Encoder(g, cc, vh), sink(cc)
     {
     }
 
-    LadderEncoder::~LadderEncoder() {}
-
-    int LadderEncoder::get_aux_var(int symbolicAuxVar)
+    template <class Sink>
+    LadderEncoder<Sink>::LadderEncoder(Graph *g, Sink *cc, VarHandler *vh, unsigned width, int *prefix_slots, int *suffix_slots, const LabelDomains *owner_domains)
+        : Encoder(g, cc, vh), sink(cc), width(width), prefix_slots(prefix_slots), suffix_slots(suffix_slots)
     {
-        auto pair = aux_vars.find(symbolicAuxVar);
-
-        if (pair != aux_vars.end())
-            return pair->second;
-
-        int new_aux_var = vh->get_new_var();
-        aux_vars.insert({symbolicAuxVar, new_aux_var});
-        return new_aux_var;
+        domains = owner_domains;
     }
 
-    int LadderEncoder::get_obj_k_aux_var(int first, int last)
-    {
+    template <class Sink>
+    LadderEncoder<Sink>::~LadderEncoder() {}
 
-        auto pair = obj_k_aux_vars.find({first, last});
+    template <class Sink>
+    int LadderEncoder<Sink>::get_aux_var(int symbolicAuxVar)
+    {
+        if (nsc_aux_vars.empty())
+            nsc_aux_vars.assign(2 * g->n * g->n + 1, 0);
 
-        if (pair != obj_k_aux_vars.end())
-            return pair->second;
+        int &aux_var = nsc_aux_vars[symbolicAuxVar - vertices_aux_var];
+        if (aux_var == 0)
+        {
+            aux_var = vh->get_new_var();
+            num_l_v_aux_vars++;
+        }
+        return aux_var;
+    }
 
+    template <class Sink>
+    int LadderEncoder<Sink>::get_obj_k_aux_var(int first, int last)
+    {
         if (first == last)
             return first;
 
-        int new_obj_k_aux_var = vh->get_new_var();
-        obj_k_aux_vars.insert({{first, last}, new_obj_k_aux_var});
-        return new_obj_k_aux_var;
+        int n = g->n;
+        int stair_anchor = (first - 1) / n * n;
+        int first_pos = first - 1 - stair_anchor;
+        int window_start = first_pos / (int)width * (int)width;
+
+        int *aux_var;
+        if (first_pos == window_start)
+        {
+            aux_var = &prefix_slots[last - 1];
+        }
+        else
+        {
+            assert(last - 1 - stair_anchor == std::min(window_start + (int)width, n) - 1);
+            aux_var = &suffix_slots[first - 1];
+        }
+
+        if (*aux_var == 0)
+        {
+            *aux_var = vh->get_new_var();
+            num_obj_k_aux_vars++;
+        }
+        return *aux_var;
     }
 
-    int LadderEncoder::do_vars_size() const
+    template <class Sink>
+    int LadderEncoder<Sink>::do_vars_size() const
     {
         return vh->size();
     };
 
-    void LadderEncoder::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    template <class Sink>
+    void LadderEncoder<Sink>::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
     {
-        aux_vars.clear();
-        obj_k_aux_vars.clear();
+        do_encode_labelling_part();
+        do_encode_width_part(w, node_pairs);
+    };
 
+    template <class Sink>
+    void LadderEncoder<Sink>::do_encode_labelling_part()
+    {
+        nsc_aux_vars.clear();
+        num_l_v_aux_vars = 0;
         num_l_v_constraints = 0;
-        num_obj_k_constraints = 0;
-        num_obj_k_glue_staircase_constraint = 0;
 
         vertices_aux_var = g->n * g->n;
         labels_aux_var = vertices_aux_var + g->n * g->n;
 
-        if (symmetry_break_point == std::string("f"))
-        {
-            encode_symmetry_break();
-        }
-        else if (symmetry_break_point == std::string("h"))
-        {
-            encode_symmetry_break_on_maxnode();
-        }
-        else if (symmetry_break_point == std::string("l"))
-        {
-            encode_symmetry_break_on_minnode();
-        }
-        else
-        {
-            // No symmetry breaking
-        }
-        std::cout << "c\tEncode symmetry breaking with option: " << symmetry_break_point << "." << std::endl;
+        encode_symmetry_break_choice();
 
         encode_vertices();
         // encode_labels();
+    };
+
+    template <class Sink>
+    void LadderEncoder<Sink>::do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
+        width = w;
+        prefix_aux_vars.assign(g->n * g->n, 0);
+        suffix_aux_vars.assign(g->n * g->n, 0);
+        prefix_slots = prefix_aux_vars.data();
+        suffix_slots = suffix_aux_vars.data();
+        num_obj_k_aux_vars = 0;
+
+        num_obj_k_constraints = 0;
+        num_obj_k_glue_staircase_constraint = 0;
+
         encode_obj_k(w);
 
         // Prevent error when build due to unused variables
         (void)node_pairs;
-        (void)w;
-        std::cout << "c\tLabels and Vertices aux var: " << aux_vars.size() << std::endl;
+        std::cout << "c\tLabels and Vertices aux var: " << num_l_v_aux_vars << std::endl;
         std::cout << "c\tLabels and Vertices constraints:  " << num_l_v_constraints << std::endl;
-        std::cout << "c\tObj k aux var: " << obj_k_aux_vars.size() << std::endl;
+        std::cout << "c\tObj k aux var: " << num_obj_k_aux_vars << std::endl;
         std::cout << "c\tObj k constraints: " << num_obj_k_constraints << std::endl;
         std::cout << "c\tObj k glue staircase constraints: " << num_obj_k_glue_staircase_constraint << std::endl;
     };
 
-    void LadderEncoder::encode_vertices()
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_vertices()
     {
         /*
             Encode that each label can only be assigned to one node.
@@ -120,7 +153,8 @@ namespace SATABP
         }
     }
 
-    void LadderEncoder::encode_labels()
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_labels()
     {
         /*
             Encode that each vertex can only take one and only one label.
@@ -144,7 +178,8 @@ namespace SATABP
         }
     }
 
-    void LadderEncoder::encode_exactly_one_NSC(std::vector<int> listVars, int auxVar)
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_exactly_one_NSC(std::vector<int> listVars, int auxVar)
     {
         // Exactly one variables in listVars is True
         // Using NSC to encode AMO and ALO, EO = AMO and ALO
@@ -156,7 +191,7 @@ namespace SATABP
         // In CNF: not(Xi) or R(i, 1)
         for (int i = 1; i <= listVarsSize - 1; i++)
         {
-            cv->add_clause({-listVars[i - 1], get_aux_var(auxVar + i)});
+            sink->add_clause(-listVars[i - 1], get_aux_var(auxVar + i));
             num_l_v_constraints++;
         }
 
@@ -164,7 +199,7 @@ namespace SATABP
         // In CNF: not(R(i-1, 1)) or R(i, 1)
         for (int i = 2; i <= listVarsSize - 1; i++)
         {
-            cv->add_clause({-(get_aux_var(auxVar + i - 1)), get_aux_var(auxVar + i)});
+            sink->add_clause(-(get_aux_var(auxVar + i - 1)), get_aux_var(auxVar + i));
             num_l_v_constraints++;
         }
 
@@ -174,41 +209,42 @@ namespace SATABP
         // In CNF: Xi or R(i-1, 1) or not (R(i, 1))
         for (int i = 2; i <= listVarsSize - 1; i++)
         {
-            cv->add_clause({listVars[i - 1], get_aux_var(auxVar + i - 1), -(get_aux_var(auxVar + i))});
+            sink->add_clause(listVars[i - 1], get_aux_var(auxVar + i - 1), -(get_aux_var(auxVar + i)));
             num_l_v_constraints++;
         }
 
         // Constraint 5: not(X1) -> not(R(1,1))
         // In CNF: X1 or not(R(1,1))
-        cv->add_clause({listVars[0], -(get_aux_var(auxVar + 1))});
+        sink->add_clause(listVars[0], -(get_aux_var(auxVar + 1)));
         num_l_v_constraints++;
 
         // Constraint 6: Since k = 1 (Exactly 1 constraint), this constraint is empty and then skipped.
 
         // Constraint 7: (At Least k) R(n-1, 1) or Xn
         // In CNF: R(n-1, 1) or Xn
-        cv->add_clause({get_aux_var(auxVar + listVarsSize - 1), listVars[listVarsSize - 1]});
+        sink->add_clause(get_aux_var(auxVar + listVarsSize - 1), listVars[listVarsSize - 1]);
         num_l_v_constraints++;
 
         // Constraint 8: (At Most k) Xi -> not(R(i-1,1)) for i in [k + 1, n]
         // In CNF: not(Xi) or not(R(i-1,1))
         for (int i = 2; i <= listVarsSize; i++)
         {
-            cv->add_clause({-listVars[i - 1], -(get_aux_var(auxVar + i - 1))});
+            sink->add_clause(-listVars[i - 1], -(get_aux_var(auxVar + i - 1)));
             num_l_v_constraints++;
         }
     }
 
-    void LadderEncoder::encode_exactly_one_product(const std::vector<int> &vars)
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_exactly_one_product(const std::vector<int> &vars)
     {
         if (vars.size() < 2)
             return;
         if (vars.size() == 2)
         {
             // simplifies to vars[0] /\ -1*vars[0], in case vars[0] == vars[1]
-            cv->add_clause({vars[0], vars[1]});
+            sink->add_clause(vars[0], vars[1]);
             num_l_v_constraints++;
-            cv->add_clause({-1 * vars[0], -1 * vars[1]});
+            sink->add_clause(-1 * vars[0], -1 * vars[1]);
             num_l_v_constraints++;
             return;
         }
@@ -223,13 +259,13 @@ namespace SATABP
         {
             int new_var = vh->get_new_var();
             u_vars.push_back(new_var);
-            aux_vars.insert({new_var, new_var});
+            num_l_v_aux_vars++;
         }
         for (int j = 1; j <= q; ++j)
         {
             int new_var = vh->get_new_var();
             v_vars.push_back(new_var);
-            aux_vars.insert({new_var, new_var});
+            num_l_v_aux_vars++;
         }
 
         int i, j;
@@ -239,21 +275,22 @@ namespace SATABP
             i = std::floor(idx / p);
             j = idx % p;
 
-            cv->add_clause({-1 * vars[idx], v_vars[i]});
+            sink->add_clause(-1 * vars[idx], v_vars[i]);
             num_l_v_constraints++;
-            cv->add_clause({-1 * vars[idx], u_vars[j]});
+            sink->add_clause(-1 * vars[idx], u_vars[j]);
             num_l_v_constraints++;
 
             or_clause.push_back(vars[idx]);
         }
-        cv->add_clause(or_clause);
+        sink->add_clause(or_clause);
         num_l_v_constraints++;
 
         encode_amo_seq(u_vars);
         encode_amo_seq(v_vars);
     };
 
-    void LadderEncoder::encode_amo_seq(const std::vector<int> &vars)
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_amo_seq(const std::vector<int> &vars)
     {
         if (vars.size() < 2)
             return;
@@ -264,34 +301,112 @@ namespace SATABP
         {
             int curr = vars[idx];
             int next = vh->get_new_var();
-            aux_vars.insert({next, next});
-            cv->add_clause({-1 * prev, -1 * curr});
+            num_l_v_aux_vars++;
+            sink->add_clause(-1 * prev, -1 * curr);
             num_l_v_constraints++;
-            cv->add_clause({-1 * prev, next});
+            sink->add_clause(-1 * prev, next);
             num_l_v_constraints++;
-            cv->add_clause({-1 * curr, next});
+            sink->add_clause(-1 * curr, next);
             num_l_v_constraints++;
 
             prev = next;
         }
-        cv->add_clause({-1 * prev, -1 * vars[vars.size() - 1]});
+        sink->add_clause(-1 * prev, -1 * vars[vars.size() - 1]);
         num_l_v_constraints++;
     };
 
-    void LadderEncoder::encode_obj_k(unsigned w)
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_obj_k(unsigned w)
     {
+        if (parallel_encoding() && g->n > 1)
+        {
+            encode_obj_k_parallel(w);
+            return;
+        }
+
         for (int i = 0; i < (int)g->n; i++)
         {
             encode_stair(i, w);
         }
 
-        for (auto edge : g->edges)
+        GlueEdges glue = split_glue_edges(g->edges);
+        for (auto edge : glue.plain)
         {
             glue_stair(edge.first - 1, edge.second - 1, w);
         }
+        for (unsigned k = 0; k < glue.aggregated_nodes.size(); ++k)
+        {
+            glue_aggregated_stair(glue.aggregated_nodes[k], glue.aggregated_neighbours[k], w);
+        }
+    }
+
+    /*
+     * Every stair takes the same number of aux vars, stair 0 is encoded first
+     * to count them. The stairs only touch their own OBJ-K aux vars and the
+     * glue clauses only use existing ones, so the workers share the arrays.
+     */
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_obj_k_parallel(unsigned w)
+    {
+        int first_stair_var = vh->last_var() + 1;
+        encode_stair(0, w);
+        int stair_vars = vh->last_var() + 1 - first_stair_var;
+
+        EncodingBlocks stair_blocks = make_blocks(g->n - 1, stair_vars);
+        std::vector<std::unique_ptr<LadderEncoder<ClauseVector>>> workers;
+        for (std::unique_ptr<EncodingBlock> &block : stair_blocks)
+        {
+            workers.emplace_back(new LadderEncoder<ClauseVector>(g, &block->clauses, &block->vars, width, prefix_slots, suffix_slots, domains));
+        }
+        run_blocks(stair_blocks, [&workers, w](EncodingBlock &block, unsigned b)
+                   {
+                       for (unsigned stair = block.first; stair < block.last; ++stair)
+                       {
+                           workers[b]->encode_stair(stair + 1, w);
+                       } });
+        append_blocks(stair_blocks);
+        for (std::unique_ptr<LadderEncoder<ClauseVector>> &worker : workers)
+        {
+            add_obj_k_stats(*worker);
+        }
+
+        GlueEdges glue = split_glue_edges(g->edges);
+        EncodingBlocks edge_blocks = make_blocks(glue.plain.size(), 0);
+        workers.clear();
+        for (std::unique_ptr<EncodingBlock> &block : edge_blocks)
+        {
+            workers.emplace_back(new LadderEncoder<ClauseVector>(g, &block->clauses, &block->vars, width, prefix_slots, suffix_slots, domains));
+        }
+        run_blocks(edge_blocks, [&workers, &glue, w](EncodingBlock &block, unsigned b)
+                   {
+                       for (unsigned e = block.first; e < block.last; ++e)
+                       {
+                           workers[b]->glue_stair(glue.plain[e].first - 1, glue.plain[e].second - 1, w);
+                       } });
+        append_blocks(edge_blocks);
+        for (std::unique_ptr<LadderEncoder<ClauseVector>> &worker : workers)
+        {
+            add_obj_k_stats(*worker);
+        }
+
+        // Takes new variables, so it stays serial.
+        for (unsigned k = 0; k < glue.aggregated_nodes.size(); ++k)
+        {
+            glue_aggregated_stair(glue.aggregated_nodes[k], glue.aggregated_neighbours[k], w);
+        }
+    }
+
+    template <class Sink>
+    void LadderEncoder<Sink>::add_obj_k_stats(const LadderEncoder<ClauseVector> &worker)
+    {
+        num_l_v_constraints += worker.num_l_v_constraints;
+        num_obj_k_aux_vars += worker.num_obj_k_aux_vars;
+        num_obj_k_constraints += worker.num_obj_k_constraints;
+        num_obj_k_glue_staircase_constraint += worker.num_obj_k_glue_staircase_constraint;
     }
 
-    void LadderEncoder::encode_stair(int stair, unsigned w)
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_stair(int stair, unsigned w)
     {
         if (is_debug_mode)
             std::cout << "Encode stair " << stair << " with width " << w << std::endl;
@@ -331,11 +446,11 @@ namespace SATABP
             for (int j = i + 1; j < number_windows; j++)
             {
                 int second_window_aux_var = get_obj_k_aux_var(windows[j].first, windows[j].second);
-                cv->add_clause({-first_window_aux_var, -second_window_aux_var});
+                sink->add_clause(-first_window_aux_var, -second_window_aux_var);
                 num_l_v_constraints++;
             }
         }
-        cv->add_clause(alo_clause);
+        sink->add_clause(alo_clause);
         num_l_v_constraints++;
     }
 
@@ -344,8 +459,11 @@ namespace SATABP
      * The first window only has lower part.
      * The last window only has upper part.
      * Other windows have both upper part and lower part.
+     * Clauses with a pruned label variable are satisfied by its unit and
+     * skipped, but their registers are still taken in the same order.
      */
-    void LadderEncoder::encode_window(int window, int stair, unsigned w)
+    template <class Sink>
+    void LadderEncoder<Sink>::encode_window(int window, int stair, unsigned w)
     {
         if (window == 0)
         {
@@ -355,14 +473,17 @@ namespace SATABP
             for (int i = w - 1; i >= 1; i--)
             {
                 int var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-var, get_obj_k_aux_var(var, lastVar)});
+                int aux_var = get_obj_k_aux_var(var, lastVar);
+                if (label_var_pruned(var))
+                    continue;
+                sink->add_clause(-var, aux_var);
                 num_obj_k_constraints++;
             }
 
             for (int i = w; i >= 2; i--)
             {
                 int var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-get_obj_k_aux_var(var, lastVar), get_obj_k_aux_var(var - 1, lastVar)});
+                sink->add_clause(-get_obj_k_aux_var(var, lastVar), get_obj_k_aux_var(var - 1, lastVar));
                 num_obj_k_constraints++;
             }
 
@@ -371,14 +492,17 @@ namespace SATABP
                 int var = stair * (int)g->n + window * (int)w + i;
                 int main = get_obj_k_aux_var(var, lastVar);
                 int sub = get_obj_k_aux_var(var + 1, lastVar);
-                cv->add_clause({var, sub, -main});
+                sink->add_clause(var, sub, -main);
                 num_obj_k_constraints++;
             }
 
             for (int i = 1; i < (int)w; i++)
             {
                 int var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-var, -get_obj_k_aux_var(var + 1, lastVar)});
+                int aux_var = get_obj_k_aux_var(var + 1, lastVar);
+                if (label_var_pruned(var))
+                    continue;
+                sink->add_clause(-var, -aux_var);
                 num_obj_k_constraints++;
             }
         }
@@ -394,14 +518,17 @@ namespace SATABP
                 for (int i = 2; i <= real_w; i++)
                 {
                     int reverse_var = stair * (int)g->n + window * (int)w + i;
-                    cv->add_clause({-reverse_var, get_obj_k_aux_var(firstVar, reverse_var)});
+                    int aux_var = get_obj_k_aux_var(firstVar, reverse_var);
+                    if (label_var_pruned(reverse_var))
+                        continue;
+                    sink->add_clause(-reverse_var, aux_var);
                     num_obj_k_constraints++;
                 }
 
                 for (int i = real_w - 1; i > 0; i--)
                 {
                     int reverse_var = stair * (int)g->n + window * (int)w + real_w - i;
-                    cv->add_clause({-get_obj_k_aux_var(firstVar, reverse_var), get_obj_k_aux_var(firstVar, reverse_var + 1)});
+                    sink->add_clause(-get_obj_k_aux_var(firstVar, reverse_var), get_obj_k_aux_var(firstVar, reverse_var + 1));
                     num_obj_k_constraints++;
                 }
 
@@ -410,14 +537,17 @@ namespace SATABP
                     int var = stair * (int)g->n + window * (int)w + real_w - i;
                     int main = get_obj_k_aux_var(firstVar, var);
                     int sub = get_obj_k_aux_var(firstVar, var - 1);
-                    cv->add_clause({sub, var, -main});
+                    sink->add_clause(sub, var, -main);
                     num_obj_k_constraints++;
                 }
 
                 for (int i = real_w; i > 1; i--)
                 {
                     int reverse_var = stair * (int)g->n + window * (int)w + i;
-                    cv->add_clause({-reverse_var, -get_obj_k_aux_var(firstVar, reverse_var - 1)});
+                    int aux_var = get_obj_k_aux_var(firstVar, reverse_var - 1);
+                    if (label_var_pruned(reverse_var))
+                        continue;
+                    sink->add_clause(-reverse_var, -aux_var);
                     num_obj_k_constraints++;
                 }
             }
@@ -427,14 +557,17 @@ namespace SATABP
                 for (int i = 2; i <= (int)w; i++)
                 {
                     int reverse_var = stair * (int)g->n + window * (int)w + i;
-                    cv->add_clause({-reverse_var, get_obj_k_aux_var(firstVar, reverse_var)});
+                    int aux_var = get_obj_k_aux_var(firstVar, reverse_var);
+                    if (label_var_pruned(reverse_var))
+                        continue;
+                    sink->add_clause(-reverse_var, aux_var);
                     num_obj_k_constraints++;
                 }
 
                 for (int i = w - 1; i >= 1; i--)
                 {
                     int reverse_var = stair * (int)g->n + window * (int)w + w - i;
-                    cv->add_clause({-get_obj_k_aux_var(firstVar, reverse_var), get_obj_k_aux_var(firstVar, reverse_var + 1)});
+                    sink->add_clause(-get_obj_k_aux_var(firstVar, reverse_var), get_obj_k_aux_var(firstVar, reverse_var + 1));
                     num_obj_k_constraints++;
                 }
 
@@ -443,14 +576,17 @@ namespace SATABP
                     int var = stair * (int)g->n + window * (int)w + w - i;
                     int main = get_obj_k_aux_var(firstVar, var);
                     int sub = get_obj_k_aux_var(firstVar, var - 1);
-                    cv->add_clause({sub, var, -main});
+                    sink->add_clause(sub, var, -main);
                     num_obj_k_constraints++;
                 }
 
                 for (int i = (int)w; i > 1; i--)
                 {
                     int reverse_var = stair * (int)g->n + window * (int)w + i;
-                    cv->add_clause({-reverse_var, -get_obj_k_aux_var(firstVar, reverse_var - 1)});
+                    int aux_var = get_obj_k_aux_var(firstVar, reverse_var - 1);
+                    if (label_var_pruned(reverse_var))
+                        continue;
+                    sink->add_clause(-reverse_var, -aux_var);
                     num_obj_k_constraints++;
                 }
             }
@@ -464,14 +600,17 @@ namespace SATABP
             for (int i = 2; i <= (int)w; i++)
             {
                 int reverse_var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-reverse_var, get_obj_k_aux_var(firstVar, reverse_var)});
+                int aux_var = get_obj_k_aux_var(firstVar, reverse_var);
+                if (label_var_pruned(reverse_var))
+                    continue;
+                sink->add_clause(-reverse_var, aux_var);
                 num_obj_k_constraints++;
             }
 
             for (int i = w - 1; i >= 1; i--)
             {
                 int reverse_var = stair * (int)g->n + window * (int)w + w - i;
-                cv->add_clause({-get_obj_k_aux_var(firstVar, reverse_var), get_obj_k_aux_var(firstVar, reverse_var + 1)});
+                sink->add_clause(-get_obj_k_aux_var(firstVar, reverse_var), get_obj_k_aux_var(firstVar, reverse_var + 1));
                 num_obj_k_constraints++;
             }
 
@@ -480,14 +619,17 @@ namespace SATABP
                 int var = stair * (int)g->n + window * (int)w + w - i;
                 int main = get_obj_k_aux_var(firstVar, var);
                 int sub = get_obj_k_aux_var(firstVar, var - 1);
-                cv->add_clause({sub, var, -main});
+                sink->add_clause(sub, var, -main);
                 num_obj_k_constraints++;
             }
 
             for (int i = (int)w; i > 1; i--)
             {
                 int reverse_var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-reverse_var, -get_obj_k_aux_var(firstVar, reverse_var - 1)});
+                int aux_var = get_obj_k_aux_var(firstVar, reverse_var - 1);
+                if (label_var_pruned(reverse_var))
+                    continue;
+                sink->add_clause(-reverse_var, -aux_var);
                 num_obj_k_constraints++;
             }
 
@@ -496,14 +638,17 @@ namespace SATABP
             for (int i = w - 1; i >= 1; i--)
             {
                 int var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-var, get_obj_k_aux_var(var, lastVar)});
+                int aux_var = get_obj_k_aux_var(var, lastVar);
+                if (label_var_pruned(var))
+                    continue;
+                sink->add_clause(-var, aux_var);
                 num_obj_k_constraints++;
             }
 
             for (int i = w; i >= 2; i--)
             {
                 int var = stair * (int)g->n + window * (int)w + i;
-                cv->add_clause({-get_obj_k_aux_var(var, lastVar), get_obj_k_aux_var(var - 1, lastVar)});
+                sink->add_clause(-get_obj_k_aux_var(var, lastVar), get_obj_k_aux_var(var - 1, lastVar));
                 num_obj_k_constraints++;
             }
 
@@ -512,7 +657,7 @@ namespace SATABP
                 int var = stair * (int)g->n + window * (int)w + i;
                 int main = get_obj_k_aux_var(var, lastVar);
                 int sub = get_obj_k_aux_var(var + 1, lastVar);
-                cv->add_clause({var, sub, -main});
+                sink->add_clause(var, sub, -main);
                 num_obj_k_constraints++;
             }
 
@@ -520,7 +665,7 @@ namespace SATABP
             // for (int i = 1; i < (int)w; i++)
             // {
             //     int var = stair * (int)g->n + window * (int)w + i;
-            //     cv->add_clause({-var, -GetEncodedAuxVar(auxStartVarLP + var + 1)});
+            //     sink->add_clause({-var, -GetEncodedAuxVar(auxStartVarLP + var + 1)});
             //     num_obj_k_constraints++;
             // }
         }
@@ -531,7 +676,8 @@ namespace SATABP
      * Using lower part of the previous window and upper part of the next window
      * as anchor points to glue.
      */
-    void LadderEncoder::glue_window(int window, int stair, unsigned w)
+    template <class Sink>
+    void LadderEncoder<Sink>::glue_window(int window, int stair, unsigned w)
     {
         /*  The stair look like this:
          *      Window 1        Window 2        Window 3        Window 4
@@ -560,7 +706,7 @@ namespace SATABP
                 int reverse_var = stair * (int)g->n + (window + 1) * (int)w + i;
                 int var = stair * (int)g->n + window * (int)w + i + 1;
 
-                cv->add_clause({-get_obj_k_aux_var(var, last_var), -get_obj_k_aux_var(first_reverse_var, reverse_var)});
+                sink->add_clause(-get_obj_k_aux_var(var, last_var), -get_obj_k_aux_var(first_reverse_var, reverse_var));
                 num_obj_k_constraints++;
             }
         }
@@ -574,13 +720,14 @@ namespace SATABP
                 int reverse_var = stair * (int)g->n + (window + 1) * (int)w + i;
                 int var = stair * (int)g->n + window * (int)w + i + 1;
 
-                cv->add_clause({-get_obj_k_aux_var(var, last_var), -get_obj_k_aux_var(first_reverse_var, reverse_var)});
+                sink->add_clause(-get_obj_k_aux_var(var, last_var), -get_obj_k_aux_var(first_reverse_var, reverse_var));
                 num_obj_k_constraints++;
             }
         }
     }
 
-    void LadderEncoder::glue_stair(int stair1, int stair2, unsigned w)
+    template <class Sink>
+    void LadderEncoder<Sink>::glue_stair(int stair1, int stair2, unsigned w)
     {
         if (is_debug_mode)
             std::cout << "Glue stair " << stair1 << " with stair " << stair2 << std::endl;
@@ -589,11 +736,15 @@ namespace SATABP
         {
             int mod = i % w;
             int subset = i / w;
+            // Parts of the step a stair's node cannot occupy are not glued.
+            unsigned first_label = subset * w + 1;
             if (mod == 0)
             {
+                if (window_pruned(stair1, first_label, first_label + w - 1) || window_pruned(stair2, first_label, first_label + w - 1))
+                    continue;
                 int firstVar = get_obj_k_aux_var(stair1 * g->n + subset * w + 1, stair1 * g->n + subset * w + w);
                 int secondVar = get_obj_k_aux_var(stair2 * g->n + subset * w + 1, stair2 * g->n + subset * w + w);
-                cv->add_clause({-firstVar, -secondVar});
+                sink->add_clause(-firstVar, -secondVar);
                 num_obj_k_constraints++;
                 num_obj_k_glue_staircase_constraint++;
             }
@@ -603,19 +754,97 @@ namespace SATABP
                 int secondVar = get_obj_k_aux_var(stair1 * g->n + subset * w + w + 1, stair1 * g->n + subset * w + w + mod);
                 int thirdVar = get_obj_k_aux_var(stair2 * g->n + subset * w + 1 + mod, stair2 * g->n + subset * w + w);
                 int forthVar = get_obj_k_aux_var(stair2 * g->n + subset * w + w + 1, stair2 * g->n + subset * w + w + mod);
-                cv->add_clause({-firstVar, -thirdVar});
-                num_obj_k_constraints++;
-                num_obj_k_glue_staircase_constraint++;
-                cv->add_clause({-firstVar, -forthVar});
-                num_obj_k_constraints++;
-                num_obj_k_glue_staircase_constraint++;
-                cv->add_clause({-secondVar, -thirdVar});
-                num_obj_k_constraints++;
-                num_obj_k_glue_staircase_constraint++;
-                cv->add_clause({-secondVar, -forthVar});
-                num_obj_k_constraints++;
-                num_obj_k_glue_staircase_constraint++;
+                bool first_open = !window_pruned(stair1, first_label + mod, first_label + w - 1);
+                bool second_open = !window_pruned(stair1, first_label + w, first_label + w - 1 + mod);
+                bool third_open = !window_pruned(stair2, first_label + mod, first_label + w - 1);
+                bool forth_open = !window_pruned(stair2, first_label + w, first_label + w - 1 + mod);
+                if (first_open && third_open)
+                {
+                    sink->add_clause(-firstVar, -thirdVar);
+                    num_obj_k_constraints++;
+                    num_obj_k_glue_staircase_constraint++;
+                }
+                if (first_open && forth_open)
+                {
+                    sink->add_clause(-firstVar, -forthVar);
+                    num_obj_k_constraints++;
+                    num_obj_k_glue_staircase_constraint++;
+                }
+                if (second_open && third_open)
+                {
+                    sink->add_clause(-secondVar, -thirdVar);
+                    num_obj_k_constraints++;
+                    num_obj_k_glue_staircase_constraint++;
+                }
+                if (second_open && forth_open)
+                {
+                    sink->add_clause(-secondVar, -forthVar);
+                    num_obj_k_constraints++;
+                    num_obj_k_glue_staircase_constraint++;
+                }
             }
         }
     }
+
+    /*
+     * Window of step i as in glue_stair: a whole window if it is aligned,
+     * otherwise the suffix of one window and the prefix of the next.
+     * Parts the stair's node cannot occupy are left out.
+     */
+    template <class Sink>
+    unsigned LadderEncoder<Sink>::step_parts(int stair, int step, unsigned w, int *parts)
+    {
+        int mod = step % w;
+        int subset = step / w;
+        int window_start = stair * g->n + subset * w;
+        unsigned first_label = subset * w + 1;
+        unsigned count = 0;
+        if (mod == 0)
+        {
+            if (!window_pruned(stair, first_label, first_label + w - 1))
+                parts[count++] = get_obj_k_aux_var(window_start + 1, window_start + w);
+            return count;
+        }
+        if (!window_pruned(stair, first_label + mod, first_label + w - 1))
+            parts[count++] = get_obj_k_aux_var(window_start + 1 + mod, window_start + w);
+        if (!window_pruned(stair, first_label + w, first_label + w - 1 + mod))
+            parts[count++] = get_obj_k_aux_var(window_start + w + 1, window_start + w + mod);
+        return count;
+    }
+
+    template <class Sink>
+    void LadderEncoder<Sink>::glue_aggregated_stair(int stair, const std::vector<int> &neighbour_stairs, unsigned w)
+    {
+        int number_step = g->n - w + 1;
+        for (int i = 0; i < number_step; i++)
+        {
+            int neighbour_in_window = vh->get_new_var();
+            num_obj_k_aux_vars++;
+
+            int parts[2];
+            for (int neighbour : neighbour_stairs)
+            {
+                unsigned part_count = step_parts(neighbour, i, w, parts);
+                for (unsigned p = 0; p < part_count; ++p)
+                {
+                    sink->add_clause(-parts[p], neighbour_in_window);
+                }
+                num_obj_k_constraints += part_count;
+                num_obj_k_glue_staircase_constraint += part_count;
+            }
+
+            unsigned part_count = step_parts(stair, i, w, parts);
+            for (unsigned p = 0; p < part_count; ++p)
+            {
+                sink->add_clause(-parts[p], -neighbour_in_window);
+            }
+            num_obj_k_constraints += part_count;
+            num_obj_k_glue_staircase_constraint += part_count;
+        }
+    }
+
+    template class LadderEncoder<ClauseContainer>;
+    template class LadderEncoder<ClauseVector>;
+    template class LadderEncoder<CadicalClauseContainer>;
+    template class LadderEncoder<DimacsWriter>;
 }
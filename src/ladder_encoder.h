@@ -2,29 +2,51 @@
 #define LADDER_ENCODER
 
 #include "encoder.h"
-#include <map>
+#include <vector>
 
 namespace SATABP
 {
 
+    /*
+     * Sink is the type of the clause container. Clauses are added to a
+     * concrete container without virtual calls, see ClauseSink.
+     */
+    template <class Sink = ClauseContainer>
     class LadderEncoder : public Encoder
     {
     public:
-        LadderEncoder(Graph *g, ClauseContainer *cc, VarHandler *vh);
+        LadderEncoder(Graph *g, Sink *cc, VarHandler *vh);
         virtual ~LadderEncoder();
 
     private:
+        template <class>
+        friend class LadderEncoder;
+
+        Sink *sink;
+
         bool is_debug_mode = false;
         bool isUsingProductAndSEQ = true;
 
         int vertices_aux_var = 0;
         int labels_aux_var = 0;
 
-        // Use to save aux vars of LABELS and VERTICES constraints
-        std::map<int, int> aux_vars = {};
+        // Use to save aux vars of LABELS and VERTICES constraints, indexed by symbolic aux var - vertices_aux_var
+        std::vector<int> nsc_aux_vars;
+        int num_l_v_aux_vars = 0;
 
-        // Use to save aux vars of OBJ-K constraints
-        std::map<std::pair<int, int>, int> obj_k_aux_vars;
+        /*
+         * Use to save aux vars of OBJ-K constraints. Every interval is a prefix or a
+         * suffix of a window of its stair, so it is stored at stair * n + position of
+         * its last (prefix) or first (suffix) label. A whole window is a prefix.
+         * 0 until the variable is first used.
+         */
+        unsigned width = 0;
+        std::vector<int> prefix_aux_vars;
+        std::vector<int> suffix_aux_vars;
+        // The arrays above, or those of the encoder a worker encodes for.
+        int *prefix_slots = nullptr;
+        int *suffix_slots = nullptr;
+        int num_obj_k_aux_vars = 0;
 
         // Number of LABELS and VERTICES constraints
         int num_l_v_constraints = 0;
@@ -33,7 +55,12 @@ namespace SATABP
         int num_obj_k_constraints = 0;
         int num_obj_k_glue_staircase_constraint = 0;
 
+        // Worker of a parallel encoding, sharing the OBJ-K aux vars and label domains of its owner.
+        LadderEncoder(Graph *g, Sink *cc, VarHandler *vh, unsigned width, int *prefix_slots, int *suffix_slots, const LabelDomains *owner_domains);
+
         void do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs) final;
+        void do_encode_labelling_part() final;
+        void do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs) final;
 
         int do_vars_size() const final;
 
@@ -47,10 +74,14 @@ namespace SATABP
         void encode_amo_seq(const std::vector<int> &vars);
 
         void encode_obj_k(unsigned w);
+        void encode_obj_k_parallel(unsigned w);
+        void add_obj_k_stats(const LadderEncoder<ClauseVector> &worker);
         void encode_stair(int stair, unsigned w);
         void encode_window(int window, int stair, unsigned w);
         void glue_window(int window, int stair, unsigned w);
         void glue_stair(int stair1, int stair2, unsigned w);
+        unsigned step_parts(int stair, int step, unsigned w, int *parts);
+        void glue_aggregated_stair(int stair, const std::vector<int> &neighbour_stairs, unsigned w);
     };
 }
 
@@ -0,0 +1,243 @@
+#include "order_encoder.h"
+#include "cadical_clauses.h"
+#include "dimacs_writer.h"
+
+#include <iostream>
+#include <algorithm>
+#include <assert.h>
+
+namespace SATABP
+{
+    template <class Sink>
+    OrderEncoder<Sink>::OrderEncoder(Graph *g, Sink *cc, VarHandler *vh) : Encoder(g, cc, vh), sink(cc)
+    {
+    }
+
+    template <class Sink>
+    OrderEncoder<Sink>::~OrderEncoder() {}
+
+    template <class Sink>
+    int OrderEncoder<Sink>::do_vars_size() const
+    {
+        return vh->size();
+    };
+
+    template <class Sink>
+    void OrderEncoder<Sink>::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
+        do_encode_labelling_part();
+        do_encode_width_part(w, node_pairs);
+    };
+
+    template <class Sink>
+    void OrderEncoder<Sink>::do_encode_labelling_part()
+    {
+        num_l_v_aux_vars = 0;
+        num_l_v_constraints = 0;
+
+        encode_symmetry_break_choice();
+        encode_order_channelling();
+        encode_column_eo();
+    };
+
+    template <class Sink>
+    void OrderEncoder<Sink>::do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
+        assert(first_order_var != 0);
+        unsigned n = g->n;
+        width = w;
+        num_register_constraints = 0;
+        num_window_constraints = 0;
+
+        first_register_var = vh->get_new_vars(2 * n * n);
+        num_register_aux_vars = 2 * n * n;
+        for (unsigned node = 0; node < n; ++node)
+        {
+            encode_registers(node);
+        }
+
+        for (std::pair<int, int> nodes : node_pairs)
+        {
+            encode_edge_windows(nodes.first - 1, nodes.second - 1);
+        }
+
+        std::cout << "c\tLabels and Vertices aux var: " << num_l_v_aux_vars << std::endl;
+        std::cout << "c\tLabels and Vertices constraints:  " << num_l_v_constraints << std::endl;
+        std::cout << "c\tRegister aux var: " << num_register_aux_vars << std::endl;
+        std::cout << "c\tRegister constraints: " << num_register_constraints << std::endl;
+        std::cout << "c\tWindow constraints: " << num_window_constraints << std::endl;
+    };
+
+    template <class Sink>
+    int OrderEncoder<Sink>::order_var(unsigned node, unsigned label) const
+    {
+        assert(node < g->n && 1 <= label && label < g->n);
+        return first_order_var + node * (g->n - 1) + label - 1;
+    };
+
+    template <class Sink>
+    int OrderEncoder<Sink>::suffix_var(unsigned node, unsigned label) const
+    {
+        assert(node < g->n && 1 <= label && label <= g->n);
+        return first_register_var + node * g->n + label - 1;
+    };
+
+    template <class Sink>
+    int OrderEncoder<Sink>::prefix_var(unsigned node, unsigned label) const
+    {
+        assert(node < g->n && 1 <= label && label <= g->n);
+        return first_register_var + (g->n + node) * g->n + label - 1;
+    };
+
+    /*
+     * With o_l = "label <= l", o_0 false and o_n true:
+     *   o_l -> o_l+1,  x_l -> o_l,  x_l -> -o_l-1,  o_l & -o_l-1 -> x_l.
+     */
+    template <class Sink>
+    void OrderEncoder<Sink>::encode_order_channelling()
+    {
+        unsigned n = g->n;
+        first_order_var = vh->get_new_vars(n * (n - 1));
+        num_l_v_aux_vars += n * (n - 1);
+
+        for (unsigned node = 0; node < n; ++node)
+        {
+            for (unsigned label = 1; label + 1 < n; ++label)
+            {
+                sink->add_clause(-1 * order_var(node, label), order_var(node, label + 1));
+                num_l_v_constraints++;
+            }
+
+            for (unsigned label = 1; label <= n; ++label)
+            {
+                int label_var = node * n + label;
+                int lits[3] = {label_var};
+                unsigned size = 1;
+                if (label < n)
+                {
+                    sink->add_clause(-1 * label_var, order_var(node, label));
+                    num_l_v_constraints++;
+                    lits[size++] = -1 * order_var(node, label);
+                }
+                if (label > 1)
+                {
+                    sink->add_clause(-1 * label_var, -1 * order_var(node, label - 1));
+                    num_l_v_constraints++;
+                    lits[size++] = order_var(node, label - 1);
+                }
+                sink->add_clause(lits, size);
+                num_l_v_constraints++;
+            }
+        }
+    };
+
+    // Every label is taken by exactly one node, at-most-one as sequential counter.
+    template <class Sink>
+    void OrderEncoder<Sink>::encode_column_eo()
+    {
+        unsigned n = g->n;
+        std::vector<int> column(n);
+        for (unsigned label = 1; label <= n; ++label)
+        {
+            for (unsigned node = 0; node < n; ++node)
+            {
+                column[node] = node * n + label;
+            }
+            sink->add_clause(column.data(), n);
+            num_l_v_constraints++;
+
+            if (n < 2)
+                continue;
+            int first_counter = vh->get_new_vars(n - 1);
+            num_l_v_aux_vars += n - 1;
+            for (unsigned i = 0; i + 1 < n; ++i)
+            {
+                int counter = first_counter + i;
+                sink->add_clause(-1 * column[i], counter);
+                sink->add_clause(-1 * column[i + 1], -1 * counter);
+                num_l_v_constraints += 2;
+                if (i + 2 < n)
+                {
+                    sink->add_clause(-1 * counter, counter + 1);
+                    num_l_v_constraints++;
+                }
+            }
+        }
+    };
+
+    /*
+     * The registers only have to be true when the node is in their range,
+     * so label -> register and the chains suffix(l+1) -> suffix(l) and
+     * prefix(l-1) -> prefix(l) within a block are enough. Label variables
+     * fixed to false by the domains imply nothing.
+     */
+    template <class Sink>
+    void OrderEncoder<Sink>::encode_registers(unsigned node)
+    {
+        unsigned n = g->n;
+        for (unsigned label = 1; label <= n; ++label)
+        {
+            int label_var = node * n + label;
+            if (!label_var_pruned(label_var))
+            {
+                sink->add_clause(-1 * label_var, suffix_var(node, label));
+                sink->add_clause(-1 * label_var, prefix_var(node, label));
+                num_register_constraints += 2;
+            }
+            if (label % width != 0 && label < n)
+            {
+                sink->add_clause(-1 * suffix_var(node, label + 1), suffix_var(node, label));
+                sink->add_clause(-1 * prefix_var(node, label), prefix_var(node, label + 1));
+                num_register_constraints += 2;
+            }
+        }
+    };
+
+    /*
+     * Window of step i as in the Ladder glue: block [s+1, s+w] for i = s,
+     * otherwise the suffix [i+1, s+w] of one block and the prefix
+     * [s+w+1, i+w] of the next, with s = i - i % w. Parts the node cannot
+     * occupy are left out.
+     */
+    template <class Sink>
+    unsigned OrderEncoder<Sink>::step_parts(int node, unsigned step, int *parts) const
+    {
+        unsigned n = g->n;
+        unsigned block_end = std::min(step - step % width + width, n);
+        unsigned count = 0;
+        if (!window_pruned(node, step + 1, block_end))
+            parts[count++] = suffix_var(node, step + 1);
+        if (step % width != 0 && !window_pruned(node, block_end + 1, step + width))
+            parts[count++] = prefix_var(node, step + width);
+        return count;
+    };
+
+    /*
+     * Windows [i+1, i+w] for i = 0..n-w, the whole block [1, n] if w >= n,
+     * which makes the formula UNSAT as no two labels are that far apart.
+     */
+    template <class Sink>
+    void OrderEncoder<Sink>::encode_edge_windows(int node1, int node2)
+    {
+        unsigned n = g->n;
+        unsigned number_steps = width < n ? n - width + 1 : 1;
+        for (unsigned step = 0; step < number_steps; ++step)
+        {
+            int parts1[2], parts2[2];
+            unsigned count1 = step_parts(node1, step, parts1);
+            unsigned count2 = step_parts(node2, step, parts2);
+            for (unsigned i = 0; i < count1; ++i)
+            {
+                for (unsigned j = 0; j < count2; ++j)
+                {
+                    sink->add_clause(-1 * parts1[i], -1 * parts2[j]);
+                    num_window_constraints++;
+                }
+            }
+        }
+    };
+
+    template class OrderEncoder<ClauseContainer>;
+    template class OrderEncoder<CadicalClauseContainer>;
+    template class OrderEncoder<DimacsWriter>;
+}
@@ -0,0 +1,76 @@
+#ifndef ORDER_ENCODER_H
+#define ORDER_ENCODER_H
+
+#include "encoder.h"
+#include <vector>
+
+namespace SATABP
+{
+
+    /*
+     * Order encoding: besides the label variables every node has order
+     * variables "label <= l" for l = 1..n-1, channelled to the label
+     * variables, which also makes every node take exactly one label.
+     * Two neighbours are at least w apart iff no window of w consecutive
+     * labels holds both. The labels are cut into blocks of w as in the
+     * Ladder staircase, and every window is the suffix of one block and the
+     * prefix of the next. Per node and label there is a suffix and a prefix
+     * register, implied by the label variable and chained within the block,
+     * so a node takes 2n registers and 4n binary clauses for any w. Every
+     * window of an edge is glued by at most four binary clauses over the
+     * registers of its parts.
+     *
+     * Window clauses over order literals alone would not be enough: a label
+     * of one node only reduces them to clauses "not label <= b or
+     * label <= a-1" of its neighbour, which fix no label variable. Through
+     * the registers the label excludes every neighbour label within
+     * distance w by unit propagation, as in the staircases.
+     *
+     * Sink is the type of the clause container, see LadderEncoder.
+     */
+    template <class Sink = ClauseContainer>
+    class OrderEncoder : public Encoder
+    {
+    public:
+        OrderEncoder(Graph *g, Sink *cc, VarHandler *vh);
+        virtual ~OrderEncoder();
+
+    private:
+        Sink *sink;
+
+        // Order variable of node 0 and label 1, the order variables of a node are consecutive.
+        int first_order_var = 0;
+
+        // Number of LABELS and VERTICES aux vars and constraints
+        int num_l_v_aux_vars = 0;
+        int num_l_v_constraints = 0;
+        // Suffix register of node 0 and label 1, followed by the prefix registers, see suffix_var/prefix_var.
+        int first_register_var = 0;
+        unsigned width = 0;
+
+        // Number of width aux vars and constraints
+        int num_register_aux_vars = 0;
+        int num_register_constraints = 0;
+        int num_window_constraints = 0;
+
+        void do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs) final;
+        void do_encode_labelling_part() final;
+        void do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs) final;
+        int do_vars_size() const final;
+
+        // node 0-based, 1 <= label <= n-1.
+        int order_var(unsigned node, unsigned label) const;
+
+        // "label in [label, end of its block]" and "label in [start of its block, label]".
+        int suffix_var(unsigned node, unsigned label) const;
+        int prefix_var(unsigned node, unsigned label) const;
+
+        void encode_order_channelling();
+        void encode_column_eo();
+        void encode_registers(unsigned node);
+        unsigned step_parts(int node, unsigned step, int *parts) const;
+        void encode_edge_windows(int node1, int node2);
+    };
+}
+
+#endif
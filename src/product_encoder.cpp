@@ -24,25 +24,29 @@ namespace SATABP
 
     void ProductEncoder::do_encode_antibandwidth(unsigned w, std::vector<std::pair<int, int>> const &node_pairs)
     {
-        if (symmetry_break_point == std::string("f"))
-        {
-            encode_symmetry_break();
-        }
-        else if (symmetry_break_point == std::string("h"))
-        {
-            encode_symmetry_break_on_maxnode();
-        }
-        else if (symmetry_break_point == std::string("l"))
-        {
-            encode_symmetry_break_on_minnode();
-        }
-        else
-        {
-            // No symmetry breaking
-        }
-        std::cout << "c\tEncode symmetry breaking with option: " << symmetry_break_point << "." << std::endl;
+        do_encode_labelling_part();
+        do_encode_width_part(w, node_pairs);
+    };
 
+    void ProductEncoder::do_encode_labelling_part()
+    {
+        encode_symmetry_break_choice();
         encode_labelling();
+    };
+
+    void ProductEncoder::do_encode_width_part(unsigned w, std::vector<std::pair<int, int>> const &node_pairs)
+    {
+        if (clique_cover)
+        {
+            for (const std::vector<int> &clique : edge_cliques(node_pairs))
+            {
+                if (clique.size() == 2)
+                    encode_pair_amo(w, clique[0], clique[1]);
+                else
+                    encode_clique_amo(w, clique);
+            }
+            return;
+        }
 
         for (std::pair<int, int> nodes : node_pairs)
         {
@@ -86,7 +90,10 @@ namespace SATABP
 
         while (amo_node1.back() <= amo_node1_to && amo_node2.back() <= amo_node2_to)
         {
-            encode_glued_amo(amo_node1.begin(), amo_node1.end(), amo_node2.begin(), amo_node2.end());
+            // A window that one of the nodes cannot occupy needs no AMO.
+            unsigned first_label = amo_node1.front() - amo_node1_from + 1;
+            if (!window_pruned(node1 - 1, first_label, first_label + w - 1) && !window_pruned(node2 - 1, first_label, first_label + w - 1))
+                encode_glued_amo(amo_node1.begin(), amo_node1.end(), amo_node2.begin(), amo_node2.end());
             amo_node1.push_back(amo_node1.back() + 1);
             amo_node1.pop_front();
             amo_node2.push_back(amo_node2.back() + 1);
@@ -94,6 +101,30 @@ namespace SATABP
         }
     };
 
+    // One AMO per window over the window labels of the nodes of the clique that can occupy it.
+    void ProductEncoder::encode_clique_amo(int w, const std::vector<int> &clique)
+    {
+        std::vector<int> window_vars;
+        for (unsigned first_label = 1; first_label + w - 1 <= g->n; ++first_label)
+        {
+            window_vars.clear();
+            unsigned members = 0;
+            for (int node : clique)
+            {
+                assert(0 < node && node <= (int)g->n);
+                if (window_pruned(node - 1, first_label, first_label + w - 1))
+                    continue;
+                members++;
+                for (int l = 0; l < w; ++l)
+                {
+                    window_vars.push_back((node - 1) * g->n + first_label + l);
+                }
+            }
+            if (members > 1)
+                encode_window_amo(window_vars);
+        }
+    };
+
     void ProductEncoder::encode_eo(vec_int_it it_begin, vec_int_it it_end)
     {
         unsigned constr_length = std::distance(it_begin, it_end);
@@ -103,8 +134,8 @@ namespace SATABP
         {
             int v1 = *it_begin;
             int v2 = *std::next(it_begin);
-            cv->add_clause({v1, v2});
-            cv->add_clause({-1 * v1, -1 * v2});
+            cv->add_clause(v1, v2);
+            cv->add_clause(-1 * v1, -1 * v2);
             return;
         }
 
@@ -126,8 +157,8 @@ namespace SATABP
             i = std::floor(idx / p);
             j = idx % p;
             curr = *i_pos;
-            cv->add_clause({-1 * curr, v_vars[i]});
-            cv->add_clause({-1 * curr, u_vars[j]});
+            cv->add_clause(-1 * curr, v_vars[i]);
+            cv->add_clause(-1 * curr, u_vars[j]);
 
             or_clause.push_back(curr);
             ++idx;
@@ -147,8 +178,8 @@ namespace SATABP
         {
             int v1 = *it_begin;
             int v2 = *std::next(it_begin);
-            cv->add_clause({v1, v2});
-            cv->add_clause({-1 * v1, -1 * v2});
+            cv->add_clause(v1, v2);
+            cv->add_clause(-1 * v1, -1 * v2);
             return;
         }
 
@@ -168,8 +199,8 @@ namespace SATABP
             i = std::floor(idx / p);
             j = idx % p;
             curr = *i_pos;
-            cv->add_clause({-1 * curr, v_vars[i]});
-            cv->add_clause({-1 * curr, u_vars[j]});
+            cv->add_clause(-1 * curr, v_vars[i]);
+            cv->add_clause(-1 * curr, u_vars[j]);
             ++idx;
         }
         encode_amo(u_vars.begin(), u_vars.end());
@@ -199,8 +230,8 @@ namespace SATABP
             i = std::floor(idx / p);
             j = idx % p;
             curr = *i_pos;
-            cv->add_clause({-1 * curr, v_vars[i]});
-            cv->add_clause({-1 * curr, u_vars[j]});
+            cv->add_clause(-1 * curr, v_vars[i]);
+            cv->add_clause(-1 * curr, u_vars[j]);
 
             if (i_pos == amo1_last)
             {
@@ -216,4 +247,29 @@ namespace SATABP
         encode_amo(v_vars.begin(), v_vars.end());
     };
 
+    // Same 2-product AMO as encode_glued_amo.
+    void ProductEncoder::encode_window_amo(const std::vector<int> &vars)
+    {
+        unsigned constr_length = vars.size();
+        assert(constr_length > 2);
+
+        int p = std::ceil(std::sqrt(constr_length));
+        int q = std::ceil((float)constr_length / (float)p);
+
+        std::vector<int> u_vars;
+        std::vector<int> v_vars;
+        for (int i = 1; i <= p; ++i)
+            u_vars.push_back(vh->get_new_var());
+        for (int j = 1; j <= q; ++j)
+            v_vars.push_back(vh->get_new_var());
+
+        for (unsigned idx = 0; idx < constr_length; ++idx)
+        {
+            cv->add_clause(-1 * vars[idx], v_vars[idx / p]);
+            cv->add_clause(-1 * vars[idx], u_vars[idx % p]);
+        }
+        encode_amo(u_vars.begin(), u_vars.end());
+        encode_amo(v_vars.begin(), v_vars.end());
+    };
+
 }
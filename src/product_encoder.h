@@ -12,14 +12,18 @@ public:
 
 private:
   void do_encode_antibandwidth(unsigned w,std::vector<std::pair<int,int>> const& node_pairs) final;
+  void do_encode_labelling_part() final;
+  void do_encode_width_part(unsigned w, std::vector<std::pair<int,int>> const& node_pairs) final;
   int do_vars_size() const final;
 
   void encode_labelling();
   void encode_pair_amo(int w, int node1, int node2);
+  void encode_clique_amo(int w, const std::vector<int>& clique);
 
   void encode_eo(vec_int_it it_begin, vec_int_it it_end);
   void encode_amo(vec_int_it it_begin, vec_int_it it_end);
   void encode_glued_amo(deq_int_it amo1_begin, deq_int_it amo1_end, deq_int_it amo2_begin, deq_int_it amo2_end);
+  void encode_window_amo(const std::vector<int>& vars);
 };
 
 }
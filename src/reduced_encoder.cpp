@@ -21,26 +21,18 @@ namespace SATABP
 
     void ReducedEncoder::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
     {
-        if (symmetry_break_point == std::string("f"))
-        {
-            encode_symmetry_break();
-        }
-        else if (symmetry_break_point == std::string("h"))
-        {
-            encode_symmetry_break_on_maxnode();
-        }
-        else if (symmetry_break_point == std::string("l"))
-        {
-            encode_symmetry_break_on_minnode();
-        }
-        else
-        {
-            // No symmetry breaking
-        }
-        std::cout << "c\tEncode symmetry breaking with option: " << symmetry_break_point << "." << std::endl;
+        do_encode_labelling_part();
+        do_encode_width_part(w, node_pairs);
+    };
 
+    void ReducedEncoder::do_encode_labelling_part()
+    {
+        encode_symmetry_break_choice();
         encode_labelling();
+    };
 
+    void ReducedEncoder::do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
         for (std::pair<int, int> nodes : node_pairs)
         {
             encode_pair_amo(w, nodes.first, nodes.second);
@@ -115,7 +107,7 @@ namespace SATABP
             or_clause.push_back(*i_pos);
             for (auto j_pos = std::next(i_pos); j_pos != it_end; ++j_pos)
             {
-                cv->add_clause({-1 * (*i_pos), -1 * (*j_pos)});
+                cv->add_clause(-1 * (*i_pos), -1 * (*j_pos));
             }
         }
         or_clause.push_back(*std::prev(it_end));
@@ -130,9 +122,9 @@ namespace SATABP
             int j_count = 1;
             for (auto j_pos = amo2_begin; j_pos != amo2_end; ++j_pos, ++j_count)
             {
-                if (i_count != j_count)
+                if (i_count != j_count && !label_var_pruned(*i_pos) && !label_var_pruned(*j_pos))
                 {
-                    cv->add_clause({-1 * (*i_pos), -1 * (*j_pos)});
+                    cv->add_clause(-1 * (*i_pos), -1 * (*j_pos));
                 }
             }
         }
@@ -140,13 +132,16 @@ namespace SATABP
 
     void ReducedEncoder::encode_next_window(deq_int_it amo1_begin, deq_int_it amo1_end, deq_int_it amo2_begin, deq_int_it amo2_end, int new_g1, int new_g2)
     {
+        // Pairs with a pruned label are satisfied by its unit.
         for (auto i_pos = std::next(amo1_begin); i_pos != amo1_end; ++i_pos)
         {
-            cv->add_clause({-1 * (*i_pos), -1 * new_g2});
+            if (!label_var_pruned(*i_pos) && !label_var_pruned(new_g2))
+                cv->add_clause(-1 * (*i_pos), -1 * new_g2);
         }
         for (auto i_pos = std::next(amo2_begin); i_pos != amo2_end; ++i_pos)
         {
-            cv->add_clause({-1 * new_g1, -1 * (*i_pos)});
+            if (!label_var_pruned(new_g1) && !label_var_pruned(*i_pos))
+                cv->add_clause(-1 * new_g1, -1 * (*i_pos));
         }
     };
 
@@ -12,6 +12,8 @@ public:
 
 private:
   void do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int,int>>& node_pairs) final;
+  void do_encode_labelling_part() final;
+  void do_encode_width_part(unsigned w, const std::vector<std::pair<int,int>>& node_pairs) final;
 
   void encode_labelling();
   void encode_pair_amo(int w, int node1, int node2);
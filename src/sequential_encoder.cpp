@@ -22,25 +22,29 @@ namespace SATABP
 
     void SeqEncoder::do_encode_antibandwidth(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
     {
-        if (symmetry_break_point == std::string("f"))
-        {
-            encode_symmetry_break();
-        }
-        else if (symmetry_break_point == std::string("h"))
-        {
-            encode_symmetry_break_on_maxnode();
-        }
-        else if (symmetry_break_point == std::string("l"))
-        {
-            encode_symmetry_break_on_minnode();
-        }
-        else
-        {
-            // No symmetry breaking
-        }
-        std::cout << "c\tEncode symmetry breaking with option: " << symmetry_break_point << "." << std::endl;
+        do_encode_labelling_part();
+        do_encode_width_part(w, node_pairs);
+    };
 
+    void SeqEncoder::do_encode_labelling_part()
+    {
+        encode_symmetry_break_choice();
         encode_labelling();
+    };
+
+    void SeqEncoder::do_encode_width_part(unsigned w, const std::vector<std::pair<int, int>> &node_pairs)
+    {
+        if (clique_cover)
+        {
+            for (const std::vector<int> &clique : edge_cliques(node_pairs))
+            {
+                if (clique.size() == 2)
+                    encode_pair_amo(w, clique[0], clique[1]);
+                else
+                    encode_clique_amo(w, clique);
+            }
+            return;
+        }
 
         for (std::pair<int, int> nodes : node_pairs)
         {
@@ -98,7 +102,10 @@ namespace SATABP
 
         while (amo_node1.back() <= amo_node1_to && amo_node2.back() <= amo_node2_to)
         {
-            encode_glued_amo(amo_node1.begin(), amo_node1.end(), amo_node2.begin(), amo_node2.end());
+            // A window that one of the nodes cannot occupy needs no AMO.
+            unsigned first_label = amo_node1.front() - amo_node1_from + 1;
+            if (!window_pruned(node1 - 1, first_label, first_label + w - 1) && !window_pruned(node2 - 1, first_label, first_label + w - 1))
+                encode_glued_amo(amo_node1.begin(), amo_node1.end(), amo_node2.begin(), amo_node2.end());
             amo_node1.push_back(amo_node1.back() + 1);
             amo_node1.pop_front();
             amo_node2.push_back(amo_node2.back() + 1);
@@ -106,6 +113,30 @@ namespace SATABP
         }
     };
 
+    // One AMO per window over the window labels of the nodes of the clique that can occupy it.
+    void SeqEncoder::encode_clique_amo(int w, const std::vector<int> &clique)
+    {
+        std::vector<int> window_vars;
+        for (unsigned first_label = 1; first_label + w - 1 <= g->n; ++first_label)
+        {
+            window_vars.clear();
+            unsigned members = 0;
+            for (int node : clique)
+            {
+                assert(0 < node && node <= (int)g->n);
+                if (window_pruned(node - 1, first_label, first_label + w - 1))
+                    continue;
+                members++;
+                for (int l = 0; l < w; ++l)
+                {
+                    window_vars.push_back((node - 1) * g->n + first_label + l);
+                }
+            }
+            if (members > 1)
+                encode_window_amo(window_vars);
+        }
+    };
+
     void SeqEncoder::encode_eo(vec_int_it it_begin, vec_int_it it_end)
     {
         std::vector<int> or_clause;
@@ -115,13 +146,13 @@ namespace SATABP
         {
             int curr = *i_pos;
             int next = vh->get_new_var();
-            cv->add_clause({-1 * prev, -1 * curr});
-            cv->add_clause({-1 * prev, next});
-            cv->add_clause({-1 * curr, next});
+            cv->add_clause(-1 * prev, -1 * curr);
+            cv->add_clause(-1 * prev, next);
+            cv->add_clause(-1 * curr, next);
             or_clause.push_back(curr);
             prev = next;
         }
-        cv->add_clause({-1 * prev, -1 * (*std::prev(it_end))});
+        cv->add_clause(-1 * prev, -1 * (*std::prev(it_end)));
         or_clause.push_back(*std::prev(it_end));
         cv->add_clause(or_clause);
     };
@@ -133,9 +164,9 @@ namespace SATABP
         {
             int curr = *i_pos;
             int next = vh->get_new_var();
-            cv->add_clause({-1 * prev, -1 * curr});
-            cv->add_clause({-1 * prev, next});
-            cv->add_clause({-1 * curr, next});
+            cv->add_clause(-1 * prev, -1 * curr);
+            cv->add_clause(-1 * prev, next);
+            cv->add_clause(-1 * curr, next);
 
             prev = next;
             if (i_pos == amo1_last)
@@ -147,7 +178,23 @@ namespace SATABP
                 ++i_pos;
             }
         }
-        cv->add_clause({-1 * prev, -1 * (*std::prev(amo2_end))});
+        cv->add_clause(-1 * prev, -1 * (*std::prev(amo2_end)));
+    };
+
+    // Same sequential AMO as encode_glued_amo.
+    void SeqEncoder::encode_window_amo(const std::vector<int> &vars)
+    {
+        int prev = vars.front();
+        for (unsigned i = 1; i + 1 < vars.size(); ++i)
+        {
+            int curr = vars[i];
+            int next = vh->get_new_var();
+            cv->add_clause(-1 * prev, -1 * curr);
+            cv->add_clause(-1 * prev, next);
+            cv->add_clause(-1 * curr, next);
+            prev = next;
+        }
+        cv->add_clause(-1 * prev, -1 * vars.back());
     };
 
 }
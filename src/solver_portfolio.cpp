@@ -0,0 +1,170 @@
+#include "solver_portfolio.h"
+
+#include <iostream>
+#include <thread>
+#include <assert.h>
+
+namespace SATABP
+{
+
+    SharedTerminator::SharedTerminator(const std::atomic<bool> &stop_flag) : stop(stop_flag) {};
+
+    bool SharedTerminator::terminate()
+    {
+        return stop.load(std::memory_order_relaxed);
+    };
+
+    FormulaTransfer::FormulaTransfer(CaDiCaL::Solver *target) : target(target) {};
+
+    unsigned FormulaTransfer::transfer(const CaDiCaL::Solver *source)
+    {
+        added = 0;
+        source->traverse_clauses(*this);
+        source->traverse_witnesses_forward(*this);
+        return added;
+    };
+
+    bool FormulaTransfer::clause(const std::vector<int> &c)
+    {
+        for (int lit : c)
+            target->add(lit);
+        target->add(0);
+        added++;
+        return true;
+    };
+
+    // The witness only reconstructs models of the source, the target does its own elimination.
+    bool FormulaTransfer::witness(const std::vector<int> &c, const std::vector<int> &)
+    {
+        return clause(c);
+    };
+
+    SolverPortfolio::SolverPortfolio(CaDiCaL::Solver *base_solver, int size, const std::string &base_configuration, bool verbose)
+        : stop(false), winner_idx(-1)
+    {
+        assert(size > 0);
+        members.push_back(base_solver);
+        descriptions.push_back("base solver");
+
+        for (int idx = 1; idx < size; ++idx)
+        {
+            CaDiCaL::Solver *member = new CaDiCaL::Solver;
+            // Options can only be set before the first clause is added, and Solver::copy would overwrite them.
+            configure_member(member, idx, base_configuration, verbose);
+            FormulaTransfer formula(member);
+            formula.transfer(base_solver);
+            assert(member->get("seed") == idx);
+            members.push_back(member);
+        }
+        results = std::vector<int>(members.size(), 0);
+    };
+
+    SolverPortfolio::~SolverPortfolio()
+    {
+        // Member 0 is the base solver, owned by the caller.
+        for (unsigned idx = 1; idx < members.size(); ++idx)
+        {
+            delete members[idx];
+        }
+    };
+
+    /*
+     * Member idx cycles through the configurations not used by the base
+     * solver, alternates between default and forced negative phases, and
+     * gets its own random seed.
+     */
+    void SolverPortfolio::configure_member(CaDiCaL::Solver *member, int idx, const std::string &base_configuration, bool verbose)
+    {
+        std::vector<std::string> configurations{"sat", "unsat", ""};
+        unsigned base_pos = 0;
+        while (base_pos < configurations.size() && configurations[base_pos] != base_configuration)
+            base_pos++;
+        std::string configuration = configurations[(base_pos + idx) % configurations.size()];
+
+        std::vector<std::string> options{"--seed=" + std::to_string(idx)};
+        bool forced_phase = (idx / configurations.size()) % 2 == 1;
+        if (forced_phase)
+        {
+            options.push_back("--forcephase");
+            options.push_back("--phase=0");
+        }
+
+        std::string description = "default configuration";
+        bool res = true;
+        if (!configuration.empty())
+        {
+            description = "--" + configuration;
+            res = member->configure(configuration.data());
+        }
+        for (const std::string &option : options)
+        {
+            res = member->set_long_option(option.data()) && res;
+            description += " " + option;
+        }
+        descriptions.push_back(description);
+        assert(member->get("seed") == idx);
+        assert(!forced_phase || (member->get("forcephase") == 1 && member->get("phase") == 0));
+
+        if (verbose)
+            std::cout << "c\tPortfolio solver " << idx << ": " << description << " (" << res << ")." << std::endl;
+    };
+
+    int SolverPortfolio::solve(const std::vector<int> &assumptions, const WidthBudget &budget)
+    {
+        std::vector<std::thread> threads;
+        for (unsigned idx = 1; idx < members.size(); ++idx)
+        {
+            threads.emplace_back(&SolverPortfolio::solve_member, this, idx, std::cref(assumptions), std::cref(budget));
+        }
+        solve_member(0, assumptions, budget);
+        for (std::thread &t : threads)
+        {
+            t.join();
+        }
+
+        if (winner_idx < 0)
+            return 0;
+
+        std::cout << "c\tPortfolio winner: solver " << winner_idx << " (" << descriptions[winner_idx] << ")." << std::endl;
+        return results[winner_idx];
+    };
+
+    void SolverPortfolio::solve_member(int idx, const std::vector<int> &assumptions, const WidthBudget &budget)
+    {
+        CaDiCaL::Solver *member = members[idx];
+        SharedTerminator shared_terminator(stop);
+        DeadlineTerminator terminator(budget, &shared_terminator);
+        member->connect_terminator(&terminator);
+        budget.apply_limits(member);
+
+        for (int lit : assumptions)
+        {
+            member->assume(lit);
+        }
+        int res = member->solve();
+        member->disconnect_terminator();
+
+        results[idx] = res;
+        if (res == 10 || res == 20)
+        {
+            int no_winner = -1;
+            if (winner_idx.compare_exchange_strong(no_winner, idx))
+            {
+                stop = true;
+            }
+        }
+    };
+
+    CaDiCaL::Solver *SolverPortfolio::winner() const
+    {
+        if (winner_idx < 0)
+            return members[0];
+        return members[winner_idx];
+    };
+
+    int SolverPortfolio::winner_id() const
+    {
+        return winner_idx;
+    };
+
+}
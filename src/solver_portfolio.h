@@ -0,0 +1,83 @@
+#ifndef SOLVER_PORTFOLIO_H
+#define SOLVER_PORTFOLIO_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "cadical.hpp"
+#include "width_budget.h"
+
+namespace SATABP
+{
+
+  // Stops a solver as soon as the shared flag is raised.
+  class SharedTerminator : public CaDiCaL::Terminator
+  {
+  public:
+    explicit SharedTerminator(const std::atomic<bool> &stop_flag);
+    bool terminate() final;
+
+  private:
+    const std::atomic<bool> &stop;
+  };
+
+  /*
+   * Adds the formula of a solver to another one: the remaining irredundant
+   * clauses and the clauses on the extension stack, which together are
+   * equivalent to the original clauses. Unlike Solver::copy it leaves the
+   * options of the target alone.
+   */
+  class FormulaTransfer : public CaDiCaL::ClauseIterator, public CaDiCaL::WitnessIterator
+  {
+  public:
+    explicit FormulaTransfer(CaDiCaL::Solver *target);
+
+    // Returns the number of clauses added.
+    unsigned transfer(const CaDiCaL::Solver *source);
+
+    bool clause(const std::vector<int> &c) override;
+    bool witness(const std::vector<int> &c, const std::vector<int> &witness) override;
+
+  private:
+    CaDiCaL::Solver *target;
+    unsigned added = 0;
+  };
+
+  /*
+   * Solves the formula of the base solver with several differently
+   * configured CaDiCaL instances in parallel. The base solver is member 0,
+   * the others are fresh solvers that get their options first and the
+   * formula of the base solver afterwards. The first member that returns
+   * SAT/UNSAT stops all others.
+   */
+  class SolverPortfolio
+  {
+  public:
+    SolverPortfolio(CaDiCaL::Solver *base_solver, int size, const std::string &base_configuration, bool verbose);
+    ~SolverPortfolio();
+
+    SolverPortfolio(const SolverPortfolio &) = delete;
+    SolverPortfolio &operator=(const SolverPortfolio &) = delete;
+
+    // Every member gets the whole budget.
+    int solve(const std::vector<int> &assumptions, const WidthBudget &budget);
+
+    CaDiCaL::Solver *winner() const;
+    int winner_id() const;
+
+  private:
+    std::vector<CaDiCaL::Solver *> members;
+    std::vector<std::string> descriptions;
+
+    std::atomic<bool> stop;
+    std::atomic<int> winner_idx;
+    std::vector<int> results;
+
+    void configure_member(CaDiCaL::Solver *member, int idx, const std::string &base_configuration, bool verbose);
+    void solve_member(int idx, const std::vector<int> &assumptions, const WidthBudget &budget);
+  };
+
+}
+
+#endif
@@ -0,0 +1,205 @@
+#include "structural_bounds.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace SATABP
+{
+
+    StructuralBounds::StructuralBounds(const Graph *graph) : g(graph)
+    {
+        neighbours = std::vector<std::vector<int>>(g->n);
+        for (std::pair<int, int> edge : g->edges)
+        {
+            if (edge.first == edge.second)
+                continue;
+            neighbours[edge.first - 1].push_back(edge.second - 1);
+            neighbours[edge.second - 1].push_back(edge.first - 1);
+        }
+        for (std::vector<int> &node_neighbours : neighbours)
+        {
+            std::sort(node_neighbours.begin(), node_neighbours.end());
+            node_neighbours.erase(std::unique(node_neighbours.begin(), node_neighbours.end()), node_neighbours.end());
+            edge_count += node_neighbours.size();
+            max_degree = std::max(max_degree, (unsigned)node_neighbours.size());
+        }
+        edge_count /= 2;
+    };
+
+    void StructuralBounds::run()
+    {
+        if (g->n < 2 || edge_count == 0)
+            return;
+
+        offer_upper(g->n - max_degree, "degree: a node of degree " + std::to_string(max_degree));
+
+        unsigned clique_size = greedy_clique_size();
+        if (clique_size >= 2)
+            offer_upper((g->n - 1) / (clique_size - 1), "clique of size " + std::to_string(clique_size));
+
+        unsigned partition_size = greedy_clique_partition_size();
+        offer_upper(partition_size, "independence: partition into " + std::to_string(partition_size) + " cliques");
+
+        closed_form_bounds();
+    };
+
+    int StructuralBounds::lower_bound() const
+    {
+        return lb;
+    };
+
+    int StructuralBounds::upper_bound() const
+    {
+        return ub;
+    };
+
+    const std::string &StructuralBounds::lower_source() const
+    {
+        return lb_source;
+    };
+
+    const std::string &StructuralBounds::upper_source() const
+    {
+        return ub_source;
+    };
+
+    bool StructuralBounds::adjacent(int u, int v) const
+    {
+        return std::binary_search(neighbours[u].begin(), neighbours[u].end(), v);
+    };
+
+    bool StructuralBounds::is_connected() const
+    {
+        std::vector<bool> reached(g->n, false);
+        std::vector<int> stack{0};
+        reached[0] = true;
+        unsigned reached_count = 1;
+        while (!stack.empty())
+        {
+            int node = stack.back();
+            stack.pop_back();
+            for (int nb : neighbours[node])
+            {
+                if (!reached[nb])
+                {
+                    reached[nb] = true;
+                    reached_count++;
+                    stack.push_back(nb);
+                }
+            }
+        }
+        return reached_count == g->n;
+    };
+
+    /*
+     * Grows a clique from each of the highest degree nodes, adding
+     * neighbours in decreasing degree order when they fit.
+     */
+    unsigned StructuralBounds::greedy_clique_size() const
+    {
+        const unsigned max_starts = 64;
+
+        std::vector<int> by_degree(g->n);
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [this](int a, int b)
+                         { return neighbours[a].size() > neighbours[b].size(); });
+
+        unsigned best = 1;
+        for (unsigned start = 0; start < std::min(max_starts, g->n); ++start)
+        {
+            int v = by_degree[start];
+            if (neighbours[v].size() + 1 <= best)
+                break;
+
+            std::vector<int> candidates(neighbours[v]);
+            std::stable_sort(candidates.begin(), candidates.end(), [this](int a, int b)
+                             { return neighbours[a].size() > neighbours[b].size(); });
+            std::vector<int> clique{v};
+            for (int u : candidates)
+            {
+                if (std::all_of(clique.begin(), clique.end(), [this, u](int c)
+                                { return adjacent(u, c); }))
+                    clique.push_back(u);
+            }
+            best = std::max(best, (unsigned)clique.size());
+        }
+        return best;
+    };
+
+    // Low degree nodes first, they have the fewest cliques to join.
+    unsigned StructuralBounds::greedy_clique_partition_size() const
+    {
+        std::vector<int> by_degree(g->n);
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [this](int a, int b)
+                         { return neighbours[a].size() < neighbours[b].size(); });
+
+        std::vector<bool> covered(g->n, false);
+        unsigned cliques = 0;
+        for (int v : by_degree)
+        {
+            if (covered[v])
+                continue;
+            covered[v] = true;
+            cliques++;
+
+            std::vector<int> clique{v};
+            for (int u : neighbours[v])
+            {
+                if (covered[u])
+                    continue;
+                if (std::all_of(clique.begin(), clique.end(), [this, u](int c)
+                                { return adjacent(u, c); }))
+                {
+                    clique.push_back(u);
+                    covered[u] = true;
+                }
+            }
+        }
+        return cliques;
+    };
+
+    void StructuralBounds::closed_form_bounds()
+    {
+        // A self loop can never be labelled apart, leave such graphs to the solver.
+        for (std::pair<int, int> edge : g->edges)
+        {
+            if (edge.first == edge.second)
+                return;
+        }
+        if (!is_connected())
+            return;
+
+        unsigned n = g->n;
+        if (edge_count == n * (n - 1) / 2)
+        {
+            offer_exact(1, "complete graph K" + std::to_string(n));
+        }
+        else if (edge_count == n - 1 && max_degree <= 2)
+        {
+            offer_exact(n / 2, "path P" + std::to_string(n));
+        }
+        else if (edge_count == n && max_degree == 2)
+        {
+            offer_exact((n - 1) / 2, "cycle C" + std::to_string(n));
+        }
+    };
+
+    void StructuralBounds::offer_upper(int bound, const std::string &source)
+    {
+        if (bound >= 1 && (ub == 0 || bound < ub))
+        {
+            ub = bound;
+            ub_source = source;
+        }
+    };
+
+    void StructuralBounds::offer_exact(int value, const std::string &source)
+    {
+        lb = value;
+        lb_source = source;
+        ub = value;
+        ub_source = source;
+    };
+
+}
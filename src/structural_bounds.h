@@ -0,0 +1,59 @@
+#ifndef STRUCTURAL_BOUNDS_H
+#define STRUCTURAL_BOUNDS_H
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace SATABP
+{
+
+  /*
+   * Antibandwidth bounds that follow from the structure of the graph alone:
+   *  - degree: a node of degree d at label 1 leaves n - w labels for its
+   *    neighbours, so w <= n - max degree;
+   *  - clique: k pairwise adjacent nodes need k - 1 gaps of w, so
+   *    w <= (n - 1) / (k - 1) for a greedily found clique of size k;
+   *  - independence: any w consecutive labels form an independent set and
+   *    a clique partition into c cliques bounds that by c, so w <= c;
+   *  - closed forms for paths, cycles and complete graphs.
+   */
+  class StructuralBounds
+  {
+  public:
+    explicit StructuralBounds(const Graph *graph);
+
+    void run();
+
+    // 0 if no bound was found.
+    int lower_bound() const;
+    int upper_bound() const;
+    const std::string &lower_source() const;
+    const std::string &upper_source() const;
+
+  private:
+    const Graph *g;
+    std::vector<std::vector<int>> neighbours; // sorted, no self loops or duplicates
+    unsigned edge_count = 0;
+    unsigned max_degree = 0;
+
+    int lb = 0;
+    int ub = 0;
+    std::string lb_source;
+    std::string ub_source;
+
+    bool adjacent(int u, int v) const;
+    bool is_connected() const;
+
+    unsigned greedy_clique_size() const;
+    unsigned greedy_clique_partition_size() const;
+    void closed_form_bounds();
+
+    void offer_upper(int bound, const std::string &source);
+    void offer_exact(int value, const std::string &source);
+  };
+
+}
+
+#endif
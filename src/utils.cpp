@@ -2,6 +2,9 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdint.h>
 #include <assert.h>
 #include <stdlib.h> //abs
 
@@ -110,6 +113,64 @@ namespace SATABP
         return max_dist;
     };
 
+    // 64-bit FNV-1a over the bytes of value.
+    static const uint64_t fnv_offset_basis = 14695981039346656037ULL;
+    static void fnv_mix(uint64_t &hash, uint64_t value)
+    {
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            hash ^= (value >> (8 * byte)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    std::string Graph::fingerprint() const
+    {
+        std::vector<std::pair<int, int>> sorted_edges(edges);
+        std::sort(sorted_edges.begin(), sorted_edges.end());
+
+        uint64_t hash = fnv_offset_basis;
+        fnv_mix(hash, n);
+        for (std::pair<int, int> edge : sorted_edges)
+        {
+            fnv_mix(hash, edge.first);
+            fnv_mix(hash, edge.second);
+        }
+
+        std::ostringstream hex;
+        hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return hex.str();
+    };
+
+    std::string Graph::structural_fingerprint() const
+    {
+        std::vector<int> degrees(n, 0);
+        for (std::pair<int, int> edge : edges)
+        {
+            degrees[edge.first - 1]++;
+            degrees[edge.second - 1]++;
+        }
+        std::vector<std::pair<int, int>> degree_pairs;
+        for (std::pair<int, int> edge : edges)
+        {
+            int d1 = degrees[edge.first - 1];
+            int d2 = degrees[edge.second - 1];
+            degree_pairs.emplace_back(std::min(d1, d2), std::max(d1, d2));
+        }
+        std::sort(degree_pairs.begin(), degree_pairs.end());
+
+        uint64_t hash = fnv_offset_basis;
+        for (std::pair<int, int> degree_pair : degree_pairs)
+        {
+            fnv_mix(hash, degree_pair.first);
+            fnv_mix(hash, degree_pair.second);
+        }
+
+        std::ostringstream key;
+        key << n << "-" << edges.size() << "-" << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return key.str();
+    };
+
     unsigned Graph::find_greatest_outdegree_node() const
     {
         assert(n > 0);
@@ -178,6 +239,13 @@ namespace SATABP
         return next_to_assign++;
     };
 
+    int VarHandler::get_new_vars(int count)
+    {
+        int first = next_to_assign;
+        next_to_assign += count;
+        return first;
+    };
+
     int VarHandler::last_var() const
     {
         return next_to_assign - 1;
@@ -20,6 +20,10 @@ namespace SATABP
     void print_stat() const;
     int calculate_antibandwidth(const std::vector<int> &node_labels) const;
     int calculate_bandwidth(const std::vector<int> &node_labels) const;
+    // Hash of n and the edge set, independent of edge order and file name.
+    std::string fingerprint() const;
+    // n, edge count and a hash of the sorted degree pairs of the edges, the same for relabelled copies.
+    std::string structural_fingerprint() const;
 
     unsigned find_greatest_outdegree_node() const;
     unsigned find_smallest_outdegree_node() const;
@@ -32,6 +36,8 @@ namespace SATABP
   public:
     VarHandler(int start_id, int input_size);
     int get_new_var();
+    // Reserves count consecutive variables and returns the first one.
+    int get_new_vars(int count);
     int last_var() const;
     int size() const;
 
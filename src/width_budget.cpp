@@ -0,0 +1,76 @@
+#include "width_budget.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace SATABP
+{
+
+    bool WidthBudget::is_limited() const
+    {
+        return conflicts >= 0 || decisions >= 0 || seconds > 0;
+    };
+
+    WidthBudget WidthBudget::scaled(double factor) const
+    {
+        auto scale = [factor](int limit)
+        {
+            if (limit <= 0)
+                return limit;
+            double scaled_limit = limit * factor;
+            if (scaled_limit >= std::numeric_limits<int>::max())
+                return std::numeric_limits<int>::max();
+            return int(scaled_limit);
+        };
+
+        WidthBudget bigger;
+        bigger.deadline = deadline;
+        bigger.conflicts = conflicts < 0 ? conflicts : scale(conflicts);
+        bigger.decisions = decisions < 0 ? decisions : scale(decisions);
+        bigger.seconds = scale(seconds);
+        return bigger;
+    };
+
+    void WidthBudget::apply_limits(CaDiCaL::Solver *s) const
+    {
+        if (conflicts >= 0)
+            s->limit("conflicts", conflicts);
+        if (decisions >= 0)
+            s->limit("decisions", decisions);
+    };
+
+    std::string WidthBudget::describe() const
+    {
+        if (!is_limited())
+            return "unlimited";
+
+        std::string description;
+        if (conflicts >= 0)
+            description += std::to_string(conflicts) + " conflicts";
+        if (decisions >= 0)
+            description += (description.empty() ? "" : ", ") + std::to_string(decisions) + " decisions";
+        if (seconds > 0)
+            description += (description.empty() ? "" : ", ") + std::to_string(seconds) + " s";
+        return description;
+    };
+
+    std::atomic<int> interrupt_requested(0);
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, "interrupt_requested is set from a signal handler");
+
+    DeadlineTerminator::DeadlineTerminator(const WidthBudget &budget, CaDiCaL::Terminator *inner_terminator)
+        : deadline(budget.deadline), inner(inner_terminator)
+    {
+        if (budget.seconds > 0)
+            deadline = std::min(deadline, std::chrono::steady_clock::now() + std::chrono::seconds(budget.seconds));
+    };
+
+    bool DeadlineTerminator::terminate()
+    {
+        if (interrupt_requested.load(std::memory_order_relaxed))
+            return true;
+        if (inner && inner->terminate())
+            return true;
+        return deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline;
+    };
+
+}
@@ -0,0 +1,52 @@
+#ifndef WIDTH_BUDGET_H
+#define WIDTH_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "cadical.hpp"
+
+namespace SATABP
+{
+
+  // Resource limits of one solve call, a negative/zero value is unlimited.
+  struct WidthBudget
+  {
+    int conflicts = -1;
+    int decisions = -1;
+    int seconds = 0;
+    // Absolute end of the whole run, shared by every width.
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+    // Only the per-width limits count, not the run deadline.
+    bool is_limited() const;
+    WidthBudget scaled(double factor) const;
+    // Solver::limit only holds for the next solve call.
+    void apply_limits(CaDiCaL::Solver *s) const;
+    std::string describe() const;
+  };
+
+  // Number of the signal that interrupted the run, 0 if none. The search stops like at its run deadline.
+  // Set from the signal handler, so it has to be lock-free; readers only need relaxed loads.
+  extern std::atomic<int> interrupt_requested;
+
+  /*
+   * Stops a solve once the budget's seconds, counted from construction, or
+   * its run deadline have passed, once the run is interrupted, or once the
+   * optional inner terminator asks for it.
+   */
+  class DeadlineTerminator : public CaDiCaL::Terminator
+  {
+  public:
+    DeadlineTerminator(const WidthBudget &budget, CaDiCaL::Terminator *inner_terminator = nullptr);
+    bool terminate() final;
+
+  private:
+    std::chrono::steady_clock::time_point deadline;
+    CaDiCaL::Terminator *inner;
+  };
+
+}
+
+#endif